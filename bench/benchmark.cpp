@@ -0,0 +1,701 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+#include "../include/block.h"
+#include "../include/sim_log.h"
+#include "../include/cache.h"
+#include "../include/virtual_memory.h"
+#include "../include/workload.h"
+#include "../include/metrics.h"
+#include "../include/snapshot.h"
+#include "../include/arena.h"
+
+using namespace std;
+
+/*
+ HOT PATH BENCHMARK SUITE
+ ------------------------
+ - Microbenchmarks for the allocator, buddy, cache and VM hot paths
+ - Scales from 10^3 up to --max-scale blocks / lines / pages
+ - Warmup runs, repeated measurements, ns/op and batch percentiles
+ - Workload generator throughput through the SPSC feed queue
+ - Cost of the metrics layer when it is switched on
+ - Checkpoint restore time from a mapped snapshot
+ - Real-memory arena strategies on an mmap'd region
+ - JSON output and comparison against a saved baseline
+*/
+
+/* -------- Allocator APIs (implemented elsewhere) -------- */
+
+void init_memory(size_t size);
+void fit_load_segments(const vector<Block> &layout, size_t totalMemory);
+int first_fit_malloc(size_t size, size_t align);
+int best_fit_malloc(size_t size, size_t align);
+void free_block(int id);
+void fit_checkpoint(SnapshotWriter &w);
+bool fit_restore(const SnapshotReader &r);
+
+void buddy_init(size_t memorySize);
+size_t buddy_malloc(size_t request, size_t align);
+void buddy_free(size_t addr, size_t originalSize);
+
+/* ================= HARNESS ================= */
+
+static const size_t BATCH = 64;   // ops timed together for one sample
+
+struct BenchConfig {
+    size_t warmup = 1;
+    size_t reps = 5;
+    size_t ops = 20000;            // ops per repetition
+    size_t workBudget = 5000000;   // ops * scale cap for O(n) benchmarks
+    size_t maxScale = 100000;
+    string filter;
+    string jsonPath;
+    string baselinePath;
+    double threshold = 10.0;       // % slowdown flagged as regression
+};
+
+struct BenchResult {
+    string name;
+    size_t scale;
+    size_t ops;
+    double nsPerOp;                // median over repetitions
+    double p50, p90, p99, minNs, maxNs;
+};
+
+// One repetition: builds state for `scale`, then times `ops`
+// operations, appending per-batch ns/op samples.
+typedef void (*BenchFn)(size_t scale, size_t ops, vector<double> &samples);
+
+struct Benchmark {
+    string name;
+    BenchFn fn;
+    bool linear;                   // op cost grows with scale
+    size_t opsFactor = 1;          // ops per --ops unit
+};
+
+typedef chrono::steady_clock Clock;
+
+static double elapsed_ns(Clock::time_point a, Clock::time_point b) {
+    return (double)chrono::duration_cast<chrono::nanoseconds>(b - a).count();
+}
+
+// Times op(i) for i in [0, ops) in batches of BATCH
+template <typename Op>
+static void time_batches(size_t ops, vector<double> &samples, Op op) {
+    for (size_t done = 0; done < ops; done += BATCH) {
+        size_t n = min(BATCH, ops - done);
+        auto begin = Clock::now();
+        for (size_t i = 0; i < n; i++)
+            op(done + i);
+        auto end = Clock::now();
+        samples.push_back(elapsed_ns(begin, end) / n);
+    }
+}
+
+static double percentile(vector<double> v, double p) {
+    if (v.empty())
+        return 0.0;
+    sort(v.begin(), v.end());
+    size_t idx = (size_t)(p / 100.0 * (v.size() - 1) + 0.5);
+    return v[min(idx, v.size() - 1)];
+}
+
+static inline uint64_t xorshift(uint64_t &s) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+}
+
+/* ================= ALLOCATOR BENCHMARKS ================= */
+
+// `scale` used 64-unit blocks separated by 32-unit holes, followed by
+// a large free tail. A 48-unit request skips every hole.
+static vector<Block> fragmented_layout(size_t scale, size_t &total) {
+    vector<Block> layout;
+    layout.reserve(scale * 2 + 1);
+
+    size_t addr = 0;
+    for (size_t i = 0; i < scale; i++) {
+        Block used(addr, 64, false, i + 1);
+        used.requested = 64;
+        layout.push_back(used);
+        layout.emplace_back(addr + 64, 32, true, -1);
+        addr += 96;
+    }
+
+    total = addr + 1024 * 1024;
+    layout.emplace_back(addr, total - addr, true, -1);
+    return layout;
+}
+
+static void bench_first_fit(size_t scale, size_t ops, vector<double> &samples) {
+    size_t total;
+    vector<Block> layout = fragmented_layout(scale, total);
+    fit_load_segments(layout, total);
+
+    time_batches(ops, samples, [](size_t) {
+        free_block(first_fit_malloc(48, 1));
+    });
+}
+
+static void bench_best_fit(size_t scale, size_t ops, vector<double> &samples) {
+    size_t total;
+    vector<Block> layout = fragmented_layout(scale, total);
+    fit_load_segments(layout, total);
+
+    time_batches(ops, samples, [](size_t) {
+        free_block(best_fit_malloc(48, 1));
+    });
+}
+
+// Frees used blocks spread over the heap; the layout is reloaded
+// (untimed) after every batch.
+static void bench_free_block(size_t scale, size_t ops, vector<double> &samples) {
+    size_t total;
+    vector<Block> layout = fragmented_layout(scale, total);
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+
+    for (size_t done = 0; done < ops; done += BATCH) {
+        fit_load_segments(layout, total);
+
+        size_t n = min(BATCH, ops - done);
+        vector<int> ids(n);
+        for (size_t i = 0; i < n; i++)
+            ids[i] = 1 + xorshift(rng) % scale;
+        sort(ids.begin(), ids.end());
+        ids.erase(unique(ids.begin(), ids.end()), ids.end());
+
+        auto begin = Clock::now();
+        for (int id : ids)
+            free_block(id);
+        auto end = Clock::now();
+        samples.push_back(elapsed_ns(begin, end) / ids.size());
+    }
+}
+
+/* ================= BUDDY BENCHMARKS ================= */
+
+// `scale` 32-unit blocks with every other one freed: the level-0
+// free list holds scale/2 entries that are never buddies.
+static void bench_buddy(size_t scale, size_t ops, vector<double> &samples) {
+    size_t memory = 32;
+    while (memory < scale * 64)
+        memory <<= 1;
+
+    buddy_init(memory);
+
+    vector<size_t> addrs(scale);
+    for (size_t i = 0; i < scale; i++)
+        addrs[i] = buddy_malloc(32, 1);
+    for (size_t i = 0; i < scale; i += 2)
+        buddy_free(addrs[i], 32);
+
+    time_batches(ops, samples, [](size_t) {
+        size_t addr = buddy_malloc(32, 1);
+        buddy_free(addr, 32);
+    });
+}
+
+/* ================= ARENA BENCHMARKS ================= */
+
+// Real-memory counterpart of fragmented_layout: `scale` live 64-byte
+// blocks separated by freed 32-byte holes. A 48-byte request fits no
+// hole, so both fit strategies scan them all (the first-fit list is
+// address ordered and the tail sits last); buddy only looks at its
+// own order.
+static void bench_arena(ArenaStrategy strategy, size_t scale, size_t ops,
+                        vector<double> &samples) {
+    arena_init(strategy, scale * 256 + 1024 * 1024);
+
+    vector<void *> holes(scale);
+    for (size_t i = 0; i < scale; i++) {
+        holes[i] = arena_malloc(32);
+        arena_malloc(64);
+    }
+    for (void *p : holes)
+        arena_free(p);
+
+    time_batches(ops, samples, [](size_t) {
+        arena_free(arena_malloc(48));
+    });
+
+    arena_release();
+}
+
+static void bench_arena_first(size_t scale, size_t ops, vector<double> &samples) {
+    bench_arena(ArenaStrategy::FIRST_FIT, scale, ops, samples);
+}
+
+static void bench_arena_best(size_t scale, size_t ops, vector<double> &samples) {
+    bench_arena(ArenaStrategy::BEST_FIT, scale, ops, samples);
+}
+
+static void bench_arena_buddy(size_t scale, size_t ops, vector<double> &samples) {
+    bench_arena(ArenaStrategy::BUDDY, scale, ops, samples);
+}
+
+/* ================= CACHE BENCHMARKS ================= */
+
+// `scale` 64-byte lines, 8-way; random addresses over twice the capacity
+// sectorSize 64: plain lines; cos mask 1: the trace alternates
+// between two way partitions
+static void bench_cache_with(size_t scale, size_t ops, vector<double> &samples,
+                             size_t sectorSize, size_t cosMask) {
+    size_t lines = 8;
+    while (lines < scale)
+        lines <<= 1;
+
+    Cache cache(lines * 64, 64, 8, ReplacePolicy::LRU, 1);
+    cache.setSectorSize(sectorSize);
+    if (cosMask) {
+        cache.setWayMask(0, 0x0F);
+        cache.setWayMask(1, 0xF0);
+    }
+
+    size_t span = lines * 64 * 2;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+    vector<size_t> trace(ops);
+    for (auto &addr : trace)
+        addr = xorshift(rng) % span;
+
+    time_batches(ops, samples, [&](size_t i) {
+        cache.access(trace[i], i & cosMask);
+    });
+}
+
+static void bench_cache(size_t scale, size_t ops, vector<double> &samples) {
+    bench_cache_with(scale, ops, samples, 64, 0);
+}
+
+static void bench_cache_sectored(size_t scale, size_t ops, vector<double> &samples) {
+    bench_cache_with(scale, ops, samples, 16, 0);
+}
+
+static void bench_cache_partitioned(size_t scale, size_t ops, vector<double> &samples) {
+    bench_cache_with(scale, ops, samples, 64, 1);
+}
+
+// L1 of `scale` lines over an L2 eight times larger, with a 16-entry
+// victim cache probed on every L1 miss
+static void bench_hierarchy_victim(size_t scale, size_t ops, vector<double> &samples) {
+    size_t lines = 8;
+    while (lines < scale)
+        lines <<= 1;
+
+    CacheHierarchy caches(Cache(lines * 64, 64, 8, ReplacePolicy::LRU, 1),
+                          Cache(lines * 64 * 8, 64, 8, ReplacePolicy::LRU, 8));
+    caches.attachVictim(16, 2);
+
+    size_t span = lines * 64 * 2;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+
+    vector<size_t> trace(ops);
+    for (auto &addr : trace)
+        addr = xorshift(rng) % span;
+
+    time_batches(ops, samples, [&](size_t i) {
+        caches.access(trace[i]);
+    });
+}
+
+/* ================= VIRTUAL MEMORY BENCHMARKS ================= */
+
+// `scale` pages with frames for half of them; 90% of accesses hit a
+// hot set that fits in memory, the rest are uniform.
+static void bench_vm(size_t scale, size_t ops, vector<double> &samples) {
+    const size_t pageSize = 4096;
+    size_t pages = max(scale, (size_t)2);
+
+    VirtualMemory vm(pages * pageSize, pages / 2 * pageSize, pageSize);
+    uint64_t rng = 0xD1B54A32D192ED03ULL;
+    size_t hot = max(pages / 4, (size_t)1);
+
+    vector<size_t> trace(ops);
+    for (auto &va : trace) {
+        uint64_t r = xorshift(rng);
+        size_t page = (r % 10) ? (r >> 8) % hot : (r >> 8) % pages;
+        va = page * pageSize + (r >> 40) % pageSize;
+    }
+
+    time_batches(ops, samples, [&](size_t i) {
+        vm.access(trace[i]);
+    });
+}
+
+/* ================= METRICS BENCHMARKS ================= */
+
+// The plain cache / VM rows above run with metrics disabled;
+// these run the same loops with recording on.
+static void bench_cache_metrics(size_t scale, size_t ops, vector<double> &samples) {
+    metrics_set_enabled(true);
+    bench_cache(scale, ops, samples);
+    metrics_set_enabled(false);
+}
+
+static void bench_vm_metrics(size_t scale, size_t ops, vector<double> &samples) {
+    metrics_set_enabled(true);
+    bench_vm(scale, ops, samples);
+    metrics_set_enabled(false);
+}
+
+/* ================= CHECKPOINT BENCHMARKS ================= */
+
+static string snapshot_path() {
+    return "/tmp/memsim_bench_" + to_string(getpid()) + ".snap";
+}
+
+// Restores a `scale`-block heap from one mapped snapshot, repeatedly
+static void bench_fit_restore(size_t scale, size_t ops, vector<double> &samples) {
+    size_t total;
+    vector<Block> layout = fragmented_layout(scale, total);
+    fit_load_segments(layout, total);
+
+    string path = snapshot_path();
+    SnapshotWriter writer;
+    fit_checkpoint(writer);
+    writer.save(path);
+
+    SnapshotReader reader;
+    reader.open(path);
+
+    time_batches(ops, samples, [&](size_t) {
+        fit_restore(reader);
+    });
+
+    reader.close();
+    unlink(path.c_str());
+}
+
+// Page table, TLB and caches of a warmed-up `scale`-page VM
+static void bench_vm_restore(size_t scale, size_t ops, vector<double> &samples) {
+    const size_t pageSize = 4096;
+    size_t pages = max(scale, (size_t)2);
+
+    VirtualMemory vm(pages * pageSize, pages / 2 * pageSize, pageSize);
+    uint64_t rng = 0x8CB92BA72F3D8DD7ULL;
+    for (size_t i = 0; i < pages; i++)
+        vm.access((xorshift(rng) % pages) * pageSize);
+
+    string path = snapshot_path();
+    SnapshotWriter writer;
+    vm.checkpoint(writer);
+    writer.save(path);
+
+    SnapshotReader reader;
+    reader.open(path);
+
+    time_batches(ops, samples, [&](size_t) {
+        vm.restore(reader);
+    });
+
+    reader.close();
+    unlink(path.c_str());
+}
+
+/* ================= WORKLOAD BENCHMARKS ================= */
+
+static volatile uint64_t bench_sink;   // keeps the consumer loop alive
+
+// End-to-end generator -> queue -> consumer; one sample per run.
+// ns/op below 10 means more than 100M events/sec. On one shared core,
+// up to 100k elements: zipf 3.9-6.0, seq and stride 2.6-4.8, and
+// chase 3.6-9.6. Chase pays one dependent miss per event once its
+// permutation outgrows L2.
+static void bench_stream(AddressPattern pattern, size_t scale, size_t ops,
+                         vector<double> &samples) {
+    StreamSpec spec;
+    spec.pattern = pattern;
+    spec.footprint = scale * spec.elemSize;
+    AddressStream stream(spec);
+
+    uint64_t checksum = 0;
+    auto begin = Clock::now();
+    uint64_t events = feed_stream(stream, ops, [&](const uint64_t *addrs, size_t n) {
+        for (size_t i = 0; i < n; i++)
+            checksum += addrs[i];
+    });
+    auto end = Clock::now();
+
+    bench_sink = checksum;
+    samples.push_back(elapsed_ns(begin, end) / events);
+}
+
+static void bench_stream_zipf(size_t scale, size_t ops, vector<double> &samples) {
+    bench_stream(AddressPattern::ZIPF, scale, ops, samples);
+}
+
+static void bench_stream_seq(size_t scale, size_t ops, vector<double> &samples) {
+    bench_stream(AddressPattern::SEQUENTIAL, scale, ops, samples);
+}
+
+static void bench_stream_stride(size_t scale, size_t ops, vector<double> &samples) {
+    bench_stream(AddressPattern::STRIDED, scale, ops, samples);
+}
+
+static void bench_stream_chase(size_t scale, size_t ops, vector<double> &samples) {
+    bench_stream(AddressPattern::POINTER_CHASE, scale, ops, samples);
+}
+
+// Zipfian stream fed live into a cache of `scale` lines
+static void bench_stream_cache(size_t scale, size_t ops, vector<double> &samples) {
+    size_t lines = 8;
+    while (lines < scale)
+        lines <<= 1;
+
+    Cache cache(lines * 64, 64, 8, ReplacePolicy::LRU, 1);
+
+    StreamSpec spec;
+    spec.footprint = lines * 64 * 4;
+    AddressStream stream(spec);
+
+    auto begin = Clock::now();
+    uint64_t events = feed_stream(stream, ops, [&](const uint64_t *addrs, size_t n) {
+        for (size_t i = 0; i < n; i++)
+            cache.access(addrs[i]);
+    });
+    auto end = Clock::now();
+
+    samples.push_back(elapsed_ns(begin, end) / events);
+}
+
+/* ================= RUNNER ================= */
+
+static const Benchmark BENCHMARKS[] = {
+    {"alloc/first_fit_malloc+free", bench_first_fit, true},
+    {"alloc/best_fit_malloc+free", bench_best_fit, true},
+    {"alloc/free_block", bench_free_block, true},
+    {"buddy/buddy_malloc+buddy_free", bench_buddy, true},
+    {"arena/first arena_malloc+free", bench_arena_first, false},
+    {"arena/best arena_malloc+free", bench_arena_best, true},
+    {"arena/buddy arena_malloc+free", bench_arena_buddy, false},
+    {"cache/Cache::access", bench_cache, false},
+    {"cache/Cache::access+sectored", bench_cache_sectored, false},
+    {"cache/Cache::access+partitioned", bench_cache_partitioned, false},
+    {"cache/CacheHierarchy::access+victim", bench_hierarchy_victim, false},
+    {"vm/VirtualMemory::access", bench_vm, true},
+    {"metrics/Cache::access+enabled", bench_cache_metrics, false},
+    {"metrics/VirtualMemory::access+enabled", bench_vm_metrics, true},
+    {"snapshot/fit_restore", bench_fit_restore, true},
+    {"snapshot/VirtualMemory::restore", bench_vm_restore, true},
+    {"workload/zipf->queue", bench_stream_zipf, false, 256},
+    {"workload/seq->queue", bench_stream_seq, false, 256},
+    {"workload/stride->queue", bench_stream_stride, false, 256},
+    {"workload/chase->queue", bench_stream_chase, false, 256},
+    {"workload/zipf->queue->Cache::access", bench_stream_cache, false, 16},
+};
+
+static BenchResult run_benchmark(const Benchmark &b, size_t scale,
+                                 const BenchConfig &cfg) {
+    size_t ops = cfg.ops * b.opsFactor;
+    if (b.linear)
+        ops = max(BATCH, min(ops, cfg.workBudget / scale));
+
+    vector<double> discard;
+    for (size_t w = 0; w < cfg.warmup; w++) {
+        discard.clear();
+        b.fn(scale, ops, discard);
+    }
+
+    vector<double> samples;
+    vector<double> repNs;
+
+    for (size_t r = 0; r < cfg.reps; r++) {
+        vector<double> rep;
+        b.fn(scale, ops, rep);
+
+        double sum = 0.0;
+        for (double v : rep)
+            sum += v;
+        repNs.push_back(rep.empty() ? 0.0 : sum / rep.size());
+        samples.insert(samples.end(), rep.begin(), rep.end());
+    }
+
+    BenchResult res;
+    res.name = b.name;
+    res.scale = scale;
+    res.ops = ops;
+    res.nsPerOp = percentile(repNs, 50);
+    res.p50 = percentile(samples, 50);
+    res.p90 = percentile(samples, 90);
+    res.p99 = percentile(samples, 99);
+    res.minNs = percentile(samples, 0);
+    res.maxNs = percentile(samples, 100);
+    return res;
+}
+
+/* ================= JSON / BASELINE ================= */
+
+static void write_json(const string &path, const vector<BenchResult> &results) {
+    ofstream out(path);
+    out << "{\n  \"benchmarks\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"scale\": " << r.scale
+            << ", \"ops\": " << r.ops
+            << fixed << setprecision(2)
+            << ", \"ns_per_op\": " << r.nsPerOp
+            << ", \"p50\": " << r.p50 << ", \"p90\": " << r.p90
+            << ", \"p99\": " << r.p99 << ", \"min\": " << r.minNs
+            << ", \"max\": " << r.maxNs << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    out << "  ]\n}\n";
+}
+
+static bool json_field(const string &line, const string &key, string &value) {
+    string tag = "\"" + key + "\": ";
+    size_t pos = line.find(tag);
+    if (pos == string::npos)
+        return false;
+
+    pos += tag.size();
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        value = line.substr(pos + 1, end - pos - 1);
+    } else {
+        size_t end = line.find_first_of(",}", pos);
+        value = line.substr(pos, end - pos);
+    }
+    return true;
+}
+
+// Reads the one-object-per-line format written by write_json
+static vector<BenchResult> read_json(const string &path) {
+    vector<BenchResult> results;
+    ifstream in(path);
+    string line;
+
+    while (getline(in, line)) {
+        string name, scale, ns;
+        if (!json_field(line, "name", name) || !json_field(line, "scale", scale)
+            || !json_field(line, "ns_per_op", ns))
+            continue;
+
+        BenchResult r = {};
+        r.name = name;
+        r.scale = strtoull(scale.c_str(), nullptr, 10);
+        r.nsPerOp = strtod(ns.c_str(), nullptr);
+        results.push_back(r);
+    }
+
+    return results;
+}
+
+// Returns the number of regressions beyond the threshold
+static int compare_baseline(const vector<BenchResult> &current,
+                            const BenchConfig &cfg) {
+    vector<BenchResult> base = read_json(cfg.baselinePath);
+    if (base.empty()) {
+        cout << "[BENCH] Baseline " << cfg.baselinePath << " has no results\n";
+        return 0;
+    }
+
+    int regressions = 0;
+    cout << "\n--- Baseline Comparison (threshold " << cfg.threshold << "%) ---\n";
+
+    for (auto &cur : current) {
+        for (auto &old : base) {
+            if (old.name != cur.name || old.scale != cur.scale)
+                continue;
+
+            double delta = old.nsPerOp > 0
+                ? (cur.nsPerOp - old.nsPerOp) / old.nsPerOp * 100 : 0.0;
+            bool slower = delta > cfg.threshold;
+            regressions += slower;
+
+            cout << left << setw(34) << cur.name << right << setw(10) << cur.scale
+                 << fixed << setprecision(2)
+                 << setw(12) << old.nsPerOp << setw(12) << cur.nsPerOp
+                 << setw(9) << showpos << delta << "%" << noshowpos
+                 << (slower ? "  REGRESSION" : "") << "\n";
+        }
+    }
+
+    return regressions;
+}
+
+/* ================= DRIVER ================= */
+
+static void usage() {
+    cout << "Usage: memsim_bench [--reps N] [--warmup N] [--ops N]\n"
+         << "                    [--max-scale N] [--filter TEXT]\n"
+         << "                    [--json FILE] [--baseline FILE] [--threshold PCT]\n";
+}
+
+int main(int argc, char **argv) {
+    BenchConfig cfg;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string val = i + 1 < argc ? argv[i + 1] : "";
+
+        if (arg == "--reps") cfg.reps = strtoul(val.c_str(), nullptr, 10), i++;
+        else if (arg == "--warmup") cfg.warmup = strtoul(val.c_str(), nullptr, 10), i++;
+        else if (arg == "--ops") cfg.ops = strtoul(val.c_str(), nullptr, 10), i++;
+        else if (arg == "--max-scale") cfg.maxScale = strtoul(val.c_str(), nullptr, 10), i++;
+        else if (arg == "--filter") cfg.filter = val, i++;
+        else if (arg == "--json") cfg.jsonPath = val, i++;
+        else if (arg == "--baseline") cfg.baselinePath = val, i++;
+        else if (arg == "--threshold") cfg.threshold = strtod(val.c_str(), nullptr), i++;
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (cfg.reps == 0)
+        cfg.reps = 1;
+
+    SIM_VERBOSE = false;
+
+    cout << "=== MEMSIM HOT PATH BENCHMARKS ===\n";
+    cout << "reps " << cfg.reps << ", warmup " << cfg.warmup
+         << ", ops/rep " << cfg.ops << ", max scale " << cfg.maxScale << "\n\n";
+
+    cout << left << setw(34) << "benchmark" << right
+         << setw(10) << "scale" << setw(9) << "ops"
+         << setw(11) << "ns/op" << setw(10) << "p50"
+         << setw(10) << "p90" << setw(10) << "p99" << "\n";
+
+    vector<BenchResult> results;
+
+    for (const Benchmark &b : BENCHMARKS) {
+        if (!cfg.filter.empty() && b.name.find(cfg.filter) == string::npos)
+            continue;
+
+        for (size_t scale = 1000; scale <= cfg.maxScale && scale <= 10000000;
+             scale *= 10) {
+            BenchResult r = run_benchmark(b, scale, cfg);
+            results.push_back(r);
+
+            cout << left << setw(34) << r.name << right
+                 << setw(10) << r.scale << setw(9) << r.ops
+                 << fixed << setprecision(1)
+                 << setw(11) << r.nsPerOp << setw(10) << r.p50
+                 << setw(10) << r.p90 << setw(10) << r.p99 << "\n";
+        }
+    }
+
+    if (!cfg.jsonPath.empty()) {
+        write_json(cfg.jsonPath, results);
+        cout << "\n[BENCH] Results written to " << cfg.jsonPath << "\n";
+    }
+
+    if (!cfg.baselinePath.empty() && compare_baseline(results, cfg) > 0)
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ REAL-MEMORY ARENA
+ -----------------
+ - One mmap'd region (MAP_NORESERVE: pages become resident when
+   they are touched, so RSS reflects the strategy)
+ - Every pointer handed out is preceded by a 16-byte in-band tag
+   holding the block size, flags and the requested size
+ - FIRST_FIT / BEST_FIT: boundary-tag footers and an explicit free
+   list threaded through free blocks, kept in address order so first
+   fit places blocks like the simulated `set allocator first`.
+   Coalescing is O(1); only a free with no free neighbour walks the
+   list to its slot
+ - BUDDY: power-of-two blocks, per-order free lists threaded through
+   free blocks, buddy found by address XOR
+ - No heap allocation and no locking inside: safe to sit under a
+   malloc shim, which serialises the calls itself
+*/
+
+enum class ArenaStrategy {
+    FIRST_FIT,
+    BEST_FIT,
+    BUDDY
+};
+
+struct ArenaStats {
+    size_t reserved;      // bytes of address space managed
+    size_t inUse;         // block bytes of live allocations, tags included
+    size_t requested;     // bytes asked for by live allocations
+    size_t peakInUse;
+    size_t freeBytes;
+    size_t largestFree;
+    size_t freeBlocks;
+    uint64_t mallocs;
+    uint64_t frees;
+    uint64_t failures;
+};
+
+// Maps a fresh region, dropping any previous one
+bool arena_init(ArenaStrategy strategy, size_t size);
+void arena_release();
+
+bool arena_contains(const void *p);
+ArenaStrategy arena_strategy();
+
+void *arena_malloc(size_t size);
+void *arena_memalign(size_t align, size_t size);
+void arena_free(void *p);
+void *arena_realloc(void *p, size_t size);
+size_t arena_usable_size(const void *p);
+
+// Walks the free lists; O(free blocks)
+ArenaStats arena_stats();
+
+// Physical walk over every block (free and used)
+typedef void (*ArenaVisitor)(const void *block, size_t size, bool used,
+                             size_t requested, void *ctx);
+void arena_walk(ArenaVisitor visit, void *ctx);
+
+// Resident set size of the whole process, from /proc/self/statm
+size_t arena_rss();
+
+bool parse_arena_strategy(const char *name, ArenaStrategy &strategy);
+const char *arena_strategy_name(ArenaStrategy strategy);
+
+#endif
@@ -4,13 +4,18 @@
 #include <cstddef>
 
 struct Block {
-    size_t start;   // starting address
-    size_t size;    // size of block
-    bool free;      // free or allocated
-    int id;         // block id (-1 if free)
+    size_t start;     // starting address (header included)
+    size_t size;      // size of block
+    bool free;        // free or allocated
+    int id;           // block id (-1 if free)
+    size_t payload;   // aligned address handed to the caller
+    size_t requested; // bytes asked for (0 if free)
+    size_t align;     // payload alignment kept across relocation
+    size_t header;    // in-band header the block was placed with
 
     Block(size_t s, size_t sz, bool f, int i)
-        : start(s), size(sz), free(f), id(i) {}
+        : start(s), size(sz), free(f), id(i), payload(s), requested(0),
+          align(1), header(0) {}
 };
 
 #endif
@@ -0,0 +1,527 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "sim_log.h"
+#include "metrics.h"
+#include "snapshot.h"
+
+// ---------- Replacement Policy ----------
+enum class ReplacePolicy {
+    FIFO,
+    LRU
+};
+
+// ---------- Cache Line ----------
+struct Line {
+    bool valid;
+    uint16_t owner;     // class of service that filled it
+    size_t tag;
+    size_t stamp;
+    uint64_t sectors;   // valid bit per sector
+
+    Line() : valid(false), owner(0), tag(0), stamp(0), sectors(0) {}
+};
+
+// ---------- Way Partitioning ----------
+// CAT-style: each class of service (core, stream, tenant) may only
+// fill and evict inside its way mask; hits are allowed in any way.
+static const size_t CACHE_MAX_COS = 16;
+
+struct PartitionStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;   // lines this class replaced
+    uint64_t lost;        // its lines replaced by another class
+};
+
+// ---------- Cache Level ----------
+class Cache {
+public:
+    size_t cacheSize;
+    size_t blockSize;
+    size_t ways;
+    size_t setsCount;
+    size_t sectorSize;    // == blockSize: unsectored
+    size_t sectorShift;   // log2(sectorSize)
+
+    std::vector<std::vector<Line>> sets;
+    ReplacePolicy policy;
+
+    size_t hits;
+    size_t misses;
+    size_t clock;
+    size_t latency;
+
+    size_t sectorMisses;  // tag present, sector not fetched yet
+    size_t fetches;       // sectors (or whole lines) brought in
+    size_t rejected;      // accesses with an unknown class of service
+
+    uint64_t wayMasks[CACHE_MAX_COS];
+    PartitionStats partitions[CACHE_MAX_COS];
+    bool partitioned;
+
+    bool evicted;         // the last access replaced a valid line...
+    size_t evictedAddr;   // ...whose block address is this
+
+    Heatmap *conflicts;   // per-set evictions, set by track()
+
+    Cache(size_t c, size_t b, size_t w,
+          ReplacePolicy p, size_t delay)
+        : cacheSize(c), blockSize(b), ways(w), sectorSize(b), sectorShift(log2(b)),
+          policy(p), hits(0), misses(0),
+          clock(0), latency(delay), sectorMisses(0), fetches(0), rejected(0),
+          partitioned(false), evicted(false), evictedAddr(0),
+          conflicts(nullptr) {
+
+        setsCount = (cacheSize / blockSize) / ways;
+        sets.resize(setsCount, std::vector<Line>(ways));
+
+        for (auto &m : wayMasks)
+            m = allWays();
+        for (auto &p : partitions)
+            p = {};
+    }
+
+    // Names this level in exported metrics
+    void track(const std::string &name) {
+        conflicts = metrics_heatmap(name, setsCount);
+    }
+
+    uint64_t allWays() const {
+        return ways >= 64 ? ~0ULL : (1ULL << ways) - 1;
+    }
+
+    // Splits every line into blockSize / bytes sectors with their own
+    // valid bits. Empties the cache.
+    bool setSectorSize(size_t bytes) {
+        if (bytes == 0 || (bytes & (bytes - 1)) || bytes > blockSize
+            || blockSize / bytes > 64)
+            return false;
+
+        sectorSize = bytes;
+        sectorShift = __builtin_ctzll(bytes);
+        for (auto &set : sets)
+            set.assign(ways, Line());
+        return true;
+    }
+
+    // Intel CAT rules: a non-empty, contiguous run of existing ways
+    bool setWayMask(size_t cos, uint64_t mask) {
+        if (cos >= CACHE_MAX_COS || mask == 0 || (mask & ~allWays()))
+            return false;
+
+        uint64_t run = mask >> __builtin_ctzll(mask);
+        if (run & (run + 1))
+            return false;
+
+        wayMasks[cos] = mask;
+        partitioned = true;
+        return true;
+    }
+
+    // cos >= CACHE_MAX_COS is refused (no lookup, no fill) rather than
+    // folded onto another class's partition
+    bool access(size_t addr, size_t cos = 0) {
+        if (cos >= CACHE_MAX_COS) {
+            rejected++;
+            evicted = false;
+            return false;
+        }
+
+        clock++;
+        metric_count(M_CACHE_ACCESSES);
+
+        size_t offsetBits = log2(blockSize);
+        size_t indexBits  = log2(setsCount);
+
+        size_t index = (addr >> offsetBits) & ((1 << indexBits) - 1);
+        size_t tag   = addr >> (offsetBits + indexBits);
+        uint64_t sector = 1ULL << ((addr & (blockSize - 1)) >> sectorShift);
+
+        PartitionStats &part = partitions[cos];
+        evicted = false;
+
+        auto &set = sets[index];
+
+        // HIT
+        for (auto &line : set) {
+            if (line.valid && line.tag == tag) {
+                if (policy == ReplacePolicy::LRU)
+                    line.stamp = clock;
+
+                if (line.sectors & sector) {
+                    hits++;
+                    part.hits++;
+                    return true;
+                }
+
+                // line present, this sector not yet fetched
+                line.sectors |= sector;
+                misses++;
+                sectorMisses++;
+                fetches++;
+                part.misses++;
+                metric_count(M_CACHE_MISSES);
+                metric_count(M_SECTOR_MISSES);
+                return false;
+            }
+        }
+
+        // MISS
+        misses++;
+        fetches++;
+        part.misses++;
+        metric_count(M_CACHE_MISSES);
+
+        uint64_t allowed = wayMasks[cos];
+
+        for (size_t i = 0; i < set.size(); i++) {
+            if ((allowed >> i & 1) && !set[i].valid) {
+                fill(set[i], tag, sector, cos);
+                return false;
+            }
+        }
+
+        // Replacement, inside this class's ways only
+        metric_count(M_CACHE_CONFLICTS);
+        metric_heat(conflicts, index);
+
+        size_t victim = SIZE_MAX;
+        size_t minStamp = SIZE_MAX;
+
+        for (size_t i = 0; i < set.size(); i++) {
+            if ((allowed >> i & 1) && set[i].stamp < minStamp) {
+                minStamp = set[i].stamp;
+                victim = i;
+            }
+        }
+
+        Line &line = set[victim];
+        evicted = true;
+        evictedAddr = (line.tag << (offsetBits + indexBits)) | (index << offsetBits);
+
+        part.evictions++;
+        if (line.owner != cos)
+            partitions[line.owner].lost++;
+
+        fill(line, tag, sector, cos);
+        return false;
+    }
+
+    double hitRate() const {
+        size_t total = hits + misses;
+        return total ? (double)hits / total : 0.0;
+    }
+
+    // Bytes brought in from the next level
+    size_t bytesFetched() const {
+        return fetches * sectorSize;
+    }
+
+    // Sector and partition figures, when either feature is in use
+    void detailStats(const std::string &name) const {
+        if (sectorSize < blockSize) {
+            std::cout << name << " Sectors: " << blockSize / sectorSize << " x "
+                 << sectorSize << " bytes\n";
+            std::cout << name << " Sector Misses: " << sectorMisses << "\n";
+            std::cout << name << " Bytes Fetched: " << bytesFetched()
+                 << " (whole lines: " << (misses - sectorMisses) * blockSize << ")\n";
+        }
+
+        if (rejected)
+            std::cout << name << " Rejected (bad class of service): " << rejected << "\n";
+
+        size_t used = 0;
+        for (auto &p : partitions)
+            used += (p.hits + p.misses) > 0;
+        if (!partitioned && used < 2)
+            return;
+
+        std::cout << name << " Partitions:\n";
+        for (size_t c = 0; c < CACHE_MAX_COS; c++) {
+            const PartitionStats &p = partitions[c];
+            if (p.hits + p.misses == 0)
+                continue;
+
+            std::cout << "  COS " << c << " mask 0x" << std::hex << wayMasks[c] << std::dec
+                 << ": hits " << p.hits << ", misses " << p.misses
+                 << ", hit rate " << 100.0 * p.hits / (p.hits + p.misses) << "%"
+                 << ", evictions " << p.evictions << ", lost " << p.lost << "\n";
+        }
+    }
+
+    // Contents only: restore() refuses a snapshot of another geometry.
+    // Way masks are configuration and are not saved.
+    void checkpoint(SnapshotWriter &w) const {
+        w.put<uint64_t>(cacheSize);
+        w.put<uint64_t>(blockSize);
+        w.put<uint64_t>(ways);
+        w.put<uint64_t>(sectorSize);
+        w.put<uint64_t>(hits);
+        w.put<uint64_t>(misses);
+        w.put<uint64_t>(clock);
+        w.put<uint64_t>(sectorMisses);
+        w.put<uint64_t>(fetches);
+        w.putArray(partitions, CACHE_MAX_COS);
+
+        std::vector<Line> lines;
+        lines.reserve(setsCount * ways);
+        for (auto &set : sets)
+            lines.insert(lines.end(), set.begin(), set.end());
+        w.putVector(lines);
+    }
+
+    bool restore(SectionCursor &cur) {
+        uint64_t size = 0, block = 0, w = 0, sector = 0, h = 0, m = 0, c = 0;
+        uint64_t sm = 0, f = 0;
+        cur.get(size);
+        cur.get(block);
+        cur.get(w);
+        cur.get(sector);
+        cur.get(h);
+        cur.get(m);
+        cur.get(c);
+        cur.get(sm);
+        cur.get(f);
+
+        size_t np = 0, n = 0;
+        const PartitionStats *parts = cur.getArray<PartitionStats>(np);
+        const Line *lines = cur.getArray<Line>(n);
+        if (!cur.ok() || size != cacheSize || block != blockSize || w != ways
+            || sector != sectorSize || np != CACHE_MAX_COS || n != setsCount * ways)
+            return false;
+
+        for (size_t s = 0; s < setsCount; s++)
+            sets[s].assign(lines + s * ways, lines + (s + 1) * ways);
+        for (size_t i = 0; i < CACHE_MAX_COS; i++)
+            partitions[i] = parts[i];
+        hits = h;
+        misses = m;
+        clock = c;
+        sectorMisses = sm;
+        fetches = f;
+        return true;
+    }
+
+private:
+    void fill(Line &line, size_t tag, uint64_t sector, size_t cos) {
+        line.valid = true;
+        line.tag = tag;
+        line.stamp = clock;
+        line.owner = cos;
+        line.sectors = sector;
+    }
+};
+
+// ---------- Victim Cache ----------
+// Small fully associative LRU buffer for lines evicted from the level
+// above. A hit swaps the line back up instead of going to the next
+// level. 0 entries: disabled.
+class VictimCache {
+public:
+    size_t entries;
+    size_t blockSize;
+    size_t latency;
+
+    std::vector<Line> lines;   // tag = block address
+
+    size_t hits;
+    size_t misses;
+    size_t inserts;
+    size_t clock;
+
+    VictimCache(size_t n = 0, size_t block = 64, size_t delay = 1)
+        : entries(n), blockSize(block), latency(delay), lines(n),
+          hits(0), misses(0), inserts(0), clock(0) {}
+
+    bool enabled() const {
+        return entries > 0;
+    }
+
+    // Removes the line on a hit: it moves back into the level above
+    bool probe(size_t addr) {
+        size_t block = addr & ~(blockSize - 1);
+
+        for (auto &line : lines) {
+            if (line.valid && line.tag == block) {
+                line.valid = false;
+                hits++;
+                metric_count(M_VICTIM_HITS);
+                return true;
+            }
+        }
+
+        misses++;
+        metric_count(M_VICTIM_MISSES);
+        return false;
+    }
+
+    void insert(size_t blockAddr) {
+        clock++;
+        inserts++;
+
+        Line *slot = &lines[0];
+        for (auto &line : lines) {
+            if (!line.valid) {
+                slot = &line;
+                break;
+            }
+            if (line.stamp < slot->stamp)
+                slot = &line;
+        }
+
+        slot->valid = true;
+        slot->tag = blockAddr;
+        slot->stamp = clock;
+    }
+
+    double hitRate() const {
+        size_t total = hits + misses;
+        return total ? (double)hits / total : 0.0;
+    }
+
+    void checkpoint(SnapshotWriter &w) const {
+        w.put<uint64_t>(hits);
+        w.put<uint64_t>(misses);
+        w.put<uint64_t>(inserts);
+        w.put<uint64_t>(clock);
+        w.putVector(lines);
+    }
+
+    bool restore(SectionCursor &cur) {
+        uint64_t h = 0, m = 0, i = 0, c = 0;
+        std::vector<Line> saved;
+        if (!cur.get(h) || !cur.get(m) || !cur.get(i) || !cur.get(c)
+            || !cur.getVector(saved) || saved.size() != entries)
+            return false;
+
+        lines.swap(saved);
+        hits = h;
+        misses = m;
+        inserts = i;
+        clock = c;
+        return true;
+    }
+};
+
+// ---------- Cache System ----------
+class CacheHierarchy {
+public:
+    Cache L1;
+    Cache L2;
+    VictimCache victim;   // between L1 and L2
+    size_t totalTime;
+    std::string logPrefix;   // prepended to per-access log lines
+
+    CacheHierarchy()
+        : CacheHierarchy(Cache(256, 32, 4, ReplacePolicy::LRU, 1),
+                         Cache(1024, 64, 4, ReplacePolicy::FIFO, 8)) {}
+
+    CacheHierarchy(const Cache &l1, const Cache &l2)
+        : L1(l1), L2(l2), totalTime(0) {
+        L1.track("L1");
+        L2.track("L2");
+    }
+
+    void attachVictim(size_t entries, size_t delay) {
+        victim = VictimCache(entries, L1.blockSize, delay);
+    }
+
+    // cos selects the way partition in both levels
+    void access(size_t addr, size_t cos = 0) {
+        if (cos >= CACHE_MAX_COS) {
+            L1.rejected++;
+            SIM_LOG << logPrefix << "REJECTED: class of service " << cos << " out of range\n";
+            return;
+        }
+
+        metric_reuse(addr / L1.blockSize);
+        totalTime += L1.latency;
+        if (L1.access(addr, cos)) {
+            SIM_LOG << logPrefix << "L1 HIT\n";
+            return;
+        }
+
+        if (victim.enabled()) {
+            // probe first: the line L1 just dropped must not match itself
+            bool hit = victim.probe(addr);
+            if (L1.evicted)
+                victim.insert(L1.evictedAddr);
+
+            if (hit) {
+                totalTime += victim.latency;
+                SIM_LOG << logPrefix << "VICTIM HIT -> swapped into L1\n";
+                return;
+            }
+        }
+
+        // A missing level has already installed the line (Cache::access
+        // fills on a miss), so promotion and refill need no second,
+        // hit-counting access
+        totalTime += L2.latency;
+        if (L2.access(addr, cos)) {
+            SIM_LOG << logPrefix << "L2 HIT -> promoted to L1\n";
+            return;
+        }
+
+        SIM_LOG << logPrefix << "CACHE MISS -> Main Memory\n";
+        totalTime += 80;
+    }
+
+    // Writes into the caller's current section
+    void checkpoint(SnapshotWriter &w) const {
+        L1.checkpoint(w);
+        L2.checkpoint(w);
+        victim.checkpoint(w);
+        w.put<uint64_t>(totalTime);
+    }
+
+    // All or nothing: levels are restored into copies and swapped in
+    bool restore(SectionCursor &cur) {
+        Cache l1 = L1, l2 = L2;
+        VictimCache v = victim;
+        uint64_t time = 0;
+        if (!l1.restore(cur) || !l2.restore(cur) || !v.restore(cur)
+            || !cur.get(time))
+            return false;
+
+        L1 = std::move(l1);
+        L2 = std::move(l2);
+        victim = std::move(v);
+        totalTime = time;
+        return true;
+    }
+
+    void stats() {
+        std::cout << "\n--- Cache Performance ---\n";
+        std::cout << "L1 Hits: " << L1.hits << "\n";
+        std::cout << "L1 Misses: " << L1.misses << "\n";
+        std::cout << "L1 Hit Rate: " << L1.hitRate() * 100 << "%\n";
+        L1.detailStats("L1");
+        std::cout << "\n";
+
+        if (victim.enabled()) {
+            std::cout << "Victim Entries: " << victim.entries << "\n";
+            std::cout << "Victim Hits: " << victim.hits << "\n";
+            std::cout << "Victim Misses: " << victim.misses << "\n";
+            std::cout << "Victim Hit Rate: " << victim.hitRate() * 100 << "%\n\n";
+        }
+
+        std::cout << "L2 Hits: " << L2.hits << "\n";
+        std::cout << "L2 Misses: " << L2.misses << "\n";
+        std::cout << "L2 Hit Rate: " << L2.hitRate() * 100 << "%\n";
+        L2.detailStats("L2");
+        std::cout << "\n";
+
+        std::cout << "Total Access Time: " << totalTime << " cycles\n";
+    }
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef FRAGMENTATION_H
+#define FRAGMENTATION_H
+
+#include <cstddef>
+
+// Point-in-time view of one allocator engine's memory
+struct FragSample {
+    size_t total;        // bytes managed by the engine
+    size_t used;         // bytes held by allocated blocks (overhead included)
+    size_t requested;    // bytes the program actually asked for
+    size_t freeBytes;    // bytes available for new allocations
+    size_t largestFree;  // largest single allocatable region
+};
+
+inline double internal_fragmentation(const FragSample &s) {
+    return s.used ? (double)(s.used - s.requested) / s.used : 0.0;
+}
+
+inline double external_fragmentation(const FragSample &s) {
+    return s.freeBytes ? 1.0 - (double)s.largestFree / s.freeBytes : 0.0;
+}
+
+#endif
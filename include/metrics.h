@@ -0,0 +1,332 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ INSTRUMENTATION LAYER
+ ---------------------
+ - Counters and log2 histograms live in per-thread shards; the
+   owning thread is the only writer, so recording is a relaxed
+   load + store with no shared cache line traffic
+ - Heatmaps (per-set conflicts) are shared, one per named cache
+ - Every recording call is guarded by METRICS_ENABLED: when off
+   the cost is one predictable branch, so it stays compiled in
+ - Snapshots, interval history and JSON / CSV / Prometheus export
+   live in src/metrics/metrics.cpp
+*/
+
+inline bool METRICS_ENABLED = false;
+
+enum MetricCounter {
+    M_ALLOCS,
+    M_ALLOC_FAILS,
+    M_FREES,
+    M_CACHE_ACCESSES,
+    M_CACHE_MISSES,
+    M_CACHE_CONFLICTS,   // misses that evicted a valid line
+    M_PAGE_ACCESSES,
+    M_PAGE_FAULTS,
+    M_TLB_ACCESSES,
+    M_TLB_MISSES,
+    M_SECTOR_MISSES,
+    M_VICTIM_HITS,
+    M_VICTIM_MISSES,
+    METRIC_COUNTERS
+};
+
+enum MetricHistogram {
+    H_ALLOC_SIZE,          // bytes requested
+    H_ALLOC_LATENCY,       // ns per allocator call
+    H_REUSE_DISTANCE,      // distinct lines touched since the line's last use
+    H_FAULT_INTERARRIVAL,  // page accesses between two faults
+    METRIC_HISTOGRAMS
+};
+
+// Bucket 0 holds 0, bucket b holds [2^(b-1), 2^b)
+static const size_t HIST_BUCKETS = 65;
+
+// Keys tracked per thread for reuse distance
+static const uint32_t REUSE_TRACK_MAX = 1 << 16;
+
+/* ================= REUSE DISTANCE ================= */
+
+// LRU stack distance: the number of distinct keys touched since a
+// key's previous use. Each tracked key marks the slot of its last
+// access in a Fenwick tree, so the distance is the count of marks past
+// that slot, O(log n). At most REUSE_TRACK_MAX keys are tracked; the
+// least recently used one is dropped to make room, so a distance that
+// large is not measured. Slots are renumbered in order when they run
+// out, which keeps the tree a fixed size.
+class StackDistance {
+private:
+    static const uint32_t SLOTS = 2 * REUSE_TRACK_MAX;
+
+    std::vector<uint32_t> tree;       // Fenwick tree over slots, 1-based
+    std::vector<uint64_t> keyAt;      // key whose last access took a slot
+    std::unordered_map<uint64_t, uint32_t> slotOf;
+    uint32_t next = 0;                // next unused slot
+
+    void add(uint32_t slot, int32_t d) {
+        for (uint32_t i = slot + 1; i <= SLOTS; i += i & -i)
+            tree[i] += d;
+    }
+
+    // marks in slots [0, end)
+    uint32_t prefix(uint32_t end) const {
+        uint32_t n = 0;
+        for (uint32_t i = end; i > 0; i -= i & -i)
+            n += tree[i];
+        return n;
+    }
+
+    // lowest marked slot: the least recently used key
+    uint32_t oldest() const {
+        uint32_t pos = 0;
+        for (uint32_t step = SLOTS; step > 0; step >>= 1) {
+            if (pos + step <= SLOTS && tree[pos + step] == 0)
+                pos += step;
+        }
+        return pos;
+    }
+
+    void renumber() {
+        std::vector<uint64_t> order;
+        order.reserve(slotOf.size());
+        for (uint32_t i = 0; i < next; i++) {
+            auto it = slotOf.find(keyAt[i]);
+            if (it != slotOf.end() && it->second == i)
+                order.push_back(keyAt[i]);
+        }
+
+        std::fill(tree.begin(), tree.end(), 0);
+        next = 0;
+        for (uint64_t key : order) {
+            keyAt[next] = key;
+            slotOf[key] = next;
+            add(next++, 1);
+        }
+    }
+
+public:
+    // Distance for this use of `key`, UINT64_MAX on a first touch
+    uint64_t touch(uint64_t key) {
+        if (tree.empty()) {
+            tree.assign(SLOTS + 1, 0);
+            keyAt.assign(SLOTS, 0);
+        }
+        if (next == SLOTS)
+            renumber();
+
+        uint64_t distance = UINT64_MAX;
+        auto it = slotOf.find(key);
+
+        if (it != slotOf.end()) {
+            distance = slotOf.size() - prefix(it->second + 1);
+            add(it->second, -1);
+        } else if (slotOf.size() == REUSE_TRACK_MAX) {
+            uint32_t victim = oldest();
+            add(victim, -1);
+            slotOf.erase(keyAt[victim]);
+        }
+
+        keyAt[next] = key;
+        slotOf[key] = next;
+        add(next++, 1);
+        return distance;
+    }
+
+    void clear() {
+        std::fill(tree.begin(), tree.end(), 0);
+        slotOf.clear();
+        next = 0;
+    }
+};
+
+inline size_t hist_bucket(uint64_t v) {
+    return v ? 64 - __builtin_clzll(v) : 0;
+}
+
+/* ================= STORAGE ================= */
+
+struct MetricsShard {
+    std::atomic<uint64_t> counters[METRIC_COUNTERS];
+    std::atomic<uint64_t> buckets[METRIC_HISTOGRAMS][HIST_BUCKETS];
+    std::atomic<uint64_t> sums[METRIC_HISTOGRAMS];
+
+    // owner-thread bookkeeping, never exported
+    uint64_t ticks;
+    StackDistance reuse;
+};
+
+struct Heatmap {
+    std::string name;
+    size_t cells;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+};
+
+struct MetricsRegistry {
+    std::mutex lock;
+    std::vector<MetricsShard *> shards;   // threads still running
+    MetricsShard retired;                 // totals of finished threads
+    std::deque<Heatmap> heatmaps;         // deque: pointers stay valid
+    uint64_t interval = 0;                // events between snapshots, 0 = off
+
+    MetricsRegistry() : retired() {}
+};
+
+inline MetricsRegistry &metrics_registry() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+// Folds a finished thread's shard into the retired totals
+inline void metrics_retire(MetricsShard *shard) {
+    MetricsRegistry &r = metrics_registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+
+    for (size_t c = 0; c < METRIC_COUNTERS; c++)
+        r.retired.counters[c] += shard->counters[c].load();
+    for (size_t h = 0; h < METRIC_HISTOGRAMS; h++) {
+        for (size_t b = 0; b < HIST_BUCKETS; b++)
+            r.retired.buckets[h][b] += shard->buckets[h][b].load();
+        r.retired.sums[h] += shard->sums[h].load();
+    }
+
+    for (size_t i = 0; i < r.shards.size(); i++) {
+        if (r.shards[i] == shard) {
+            r.shards.erase(r.shards.begin() + i);
+            break;
+        }
+    }
+    delete shard;
+}
+
+struct MetricsThread {
+    MetricsShard *shard = nullptr;
+
+    ~MetricsThread() {
+        if (shard)
+            metrics_retire(shard);
+    }
+};
+
+inline thread_local MetricsThread metrics_thread;
+
+inline MetricsShard &metrics_shard() {
+    if (!metrics_thread.shard) {
+        MetricsShard *shard = new MetricsShard();
+        MetricsRegistry &r = metrics_registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        r.shards.push_back(shard);
+        metrics_thread.shard = shard;
+    }
+    return *metrics_thread.shard;
+}
+
+// Same name and set count, same heatmap: caches of one geometry share
+// their cells. A different set count under the same name gets its own
+// heatmap; exports tell them apart by the set count.
+inline Heatmap *metrics_heatmap(const std::string &name, size_t cells) {
+    MetricsRegistry &r = metrics_registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+
+    for (auto &h : r.heatmaps) {
+        if (h.name == name && h.cells == cells)
+            return &h;
+    }
+
+    r.heatmaps.push_back({name, cells, std::unique_ptr<std::atomic<uint64_t>[]>(
+                                           new std::atomic<uint64_t>[cells]())});
+    return &r.heatmaps.back();
+}
+
+/* ================= HOT PATH ================= */
+
+inline void bump(std::atomic<uint64_t> &cell, uint64_t n) {
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void metric_count(MetricCounter c, uint64_t n = 1) {
+    if (METRICS_ENABLED)
+        bump(metrics_shard().counters[c], n);
+}
+
+inline void metric_record(MetricHistogram h, uint64_t value) {
+    if (METRICS_ENABLED) {
+        MetricsShard &s = metrics_shard();
+        bump(s.buckets[h][hist_bucket(value)], 1);
+        bump(s.sums[h], value);
+    }
+}
+
+// 0 when disabled, so callers can time unconditionally
+inline uint64_t metrics_clock() {
+    if (!METRICS_ENABLED)
+        return 0;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void metric_latency(MetricHistogram h, uint64_t start) {
+    if (METRICS_ENABLED && start)
+        metric_record(h, metrics_clock() - start);
+}
+
+// Reuse distance in distinct lines for the given line / page key
+inline void metric_reuse(uint64_t key) {
+    if (METRICS_ENABLED) {
+        uint64_t distance = metrics_shard().reuse.touch(key);
+        if (distance != UINT64_MAX)
+            metric_record(H_REUSE_DISTANCE, distance);
+    }
+}
+
+inline void metric_heat(Heatmap *h, size_t cell) {
+    if (METRICS_ENABLED && h && cell < h->cells)
+        h->counts[cell].fetch_add(1, std::memory_order_relaxed);
+}
+
+void metrics_interval_snapshot();
+
+// One simulated event; takes an interval snapshot when one is due
+inline void metrics_tick() {
+    if (METRICS_ENABLED) {
+        MetricsShard &s = metrics_shard();
+        uint64_t interval = metrics_registry().interval;
+        if (interval && ++s.ticks % interval == 0)
+            metrics_interval_snapshot();
+    }
+}
+
+/* ================= SNAPSHOTS / EXPORT ================= */
+
+struct MetricsSnapshot {
+    uint64_t seq;         // 0 for an on-demand snapshot
+    uint64_t timeNs;      // since the last reset
+    uint64_t counters[METRIC_COUNTERS];
+    uint64_t buckets[METRIC_HISTOGRAMS][HIST_BUCKETS];
+    uint64_t sums[METRIC_HISTOGRAMS];
+    std::vector<std::pair<std::string, std::vector<uint64_t>>> heatmaps;
+};
+
+MetricsSnapshot metrics_snapshot();
+void metrics_set_enabled(bool on);
+void metrics_set_interval(uint64_t events);
+void metrics_reset();
+void metrics_print();
+
+// format: json | csv | prom
+bool metrics_export(const std::string &format, const std::string &path);
+
+#endif
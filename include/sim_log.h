@@ -0,0 +1,12 @@
+#ifndef SIM_LOG_H
+#define SIM_LOG_H
+
+#include <iostream>
+
+// Per-operation trace output ("[FIRST FIT] Allocated block 3", ...).
+// Benchmarks and long replays switch it off; dumps and stats always print.
+inline bool SIM_VERBOSE = true;
+
+#define SIM_LOG if (!SIM_VERBOSE) {} else std::cout
+
+#endif
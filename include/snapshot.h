@@ -0,0 +1,185 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+ CHECKPOINT FORMAT
+ -----------------
+ [SnapshotHeader][SectionEntry x sections][section payloads]
+
+ - Every value and array starts on an 8-byte boundary, so a mapped
+   file can be read in place: arrays are handed out as pointers into
+   the mapping and restored with one bulk copy each
+ - Arrays are stored as (count, element size, bytes); the element
+   size is checked on load, so a layout change is caught instead of
+   silently misread
+ - Engine configuration (headers, compaction policy, ...) is not
+   stored: a what-if run may change it after restoring
+ - memsim saves and forks the heap engines. The pipeline's warm start
+   adds SEC_VM (page table, TLB and the VM's own caches, written by
+   VirtualMemory) and SEC_CACHE (the stage-3 CacheHierarchy)
+ - Bump SNAPSHOT_VERSION whenever a section layout changes
+*/
+
+static const char SNAPSHOT_MAGIC[8] = {'M', 'E', 'M', 'S', 'I', 'M', 'C', 'P'};
+static const uint32_t SNAPSHOT_VERSION = 7;
+
+enum SnapshotSection : uint32_t {
+    SEC_FIT = 1,
+    SEC_BUDDY,
+    SEC_SLAB,
+    SEC_TLSF,
+    SEC_VM,
+    SEC_CACHE
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sections;
+    uint64_t fileSize;
+};
+
+struct SectionEntry {
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t offset;   // from the start of the file
+    uint64_t size;
+};
+
+inline size_t snapshot_pad(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+/* ================= WRITER ================= */
+
+class SnapshotWriter {
+private:
+    std::vector<std::pair<uint32_t, std::vector<char>>> sections;
+
+    void append(const void *data, size_t n) {
+        std::vector<char> &buf = sections.back().second;
+        size_t at = buf.size();
+        buf.resize(at + snapshot_pad(n), 0);
+        if (n)
+            std::memcpy(buf.data() + at, data, n);
+    }
+
+public:
+    // Starts a new section; following puts land in it
+    void section(SnapshotSection kind) {
+        sections.push_back({kind, {}});
+    }
+
+    template <typename T>
+    void put(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be POD");
+        append(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void putArray(const T *data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot arrays must be POD");
+        put<uint64_t>(count);
+        put<uint64_t>(sizeof(T));
+        append(data, count * sizeof(T));
+    }
+
+    template <typename T>
+    void putVector(const std::vector<T> &v) {
+        putArray(v.data(), v.size());
+    }
+
+    bool save(const std::string &path) const;
+};
+
+/* ================= READER ================= */
+
+// Bounds-checked walk over one section of a mapped snapshot
+class SectionCursor {
+private:
+    const char *p;
+    const char *end;
+    bool good;
+
+public:
+    SectionCursor() : p(nullptr), end(nullptr), good(false) {}
+    SectionCursor(const char *begin, size_t size) : p(begin), end(begin + size), good(true) {}
+
+    bool ok() const { return good; }
+
+    // Bytes left; bounds a record count before reading that many records
+    size_t remaining() const { return good ? end - p : 0; }
+
+    template <typename T>
+    bool get(T &out) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be POD");
+        if (!good || (size_t)(end - p) < sizeof(T))
+            return good = false;
+        std::memcpy(&out, p, sizeof(T));
+        p += snapshot_pad(sizeof(T));
+        return true;
+    }
+
+    // Points into the mapping; valid while the reader is open
+    template <typename T>
+    const T *getArray(size_t &count) {
+        uint64_t n = 0, elem = 0;
+        if (!get(n) || !get(elem) || elem != sizeof(T)
+            || n > (size_t)(end - p) / sizeof(T)) {
+            good = false;
+            count = 0;
+            return nullptr;
+        }
+
+        const T *data = reinterpret_cast<const T *>(p);
+        p += snapshot_pad(n * sizeof(T));
+        if (p > end)
+            p = end;
+        count = n;
+        return data;
+    }
+
+    template <typename T>
+    bool getVector(std::vector<T> &v) {
+        size_t n;
+        const T *data = getArray<T>(n);
+        if (!good)
+            return false;
+        v.assign(data, data + n);
+        return true;
+    }
+};
+
+// Read-only mmap of a snapshot file. One reader can restore any number
+// of forks; the kernel shares the mapped pages between them.
+class SnapshotReader {
+private:
+    const char *base;
+    size_t size;
+    std::string error;
+
+public:
+    SnapshotReader() : base(nullptr), size(0) {}
+    ~SnapshotReader() { close(); }
+
+    SnapshotReader(const SnapshotReader &) = delete;
+    SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const std::string &lastError() const { return error; }
+
+    // false when the snapshot has no such section
+    bool section(SnapshotSection kind, SectionCursor &cursor) const;
+};
+
+#endif
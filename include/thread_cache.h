@@ -0,0 +1,30 @@
+#ifndef THREAD_CACHE_H
+#define THREAD_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Counters aggregated over all threads that have used the allocator
+struct TcCounters {
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t failures;
+    uint64_t refills;      // batches pulled from the central pool
+    uint64_t flushes;      // batches returned to the central pool
+    uint64_t casRetries;   // failed CAS attempts on central free lists
+};
+
+// Not thread-safe: call while no other thread is using the allocator
+void tc_init(size_t memorySize);
+
+// Thread-safe allocation API (returns SIZE_MAX on failure)
+size_t tc_malloc(size_t size);
+void tc_free(size_t addr);
+
+// Returns the calling thread's magazines to the central pool
+void tc_thread_flush();
+
+TcCounters tc_counters();
+void tc_stats();
+
+#endif
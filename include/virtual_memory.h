@@ -0,0 +1,296 @@
+#ifndef VIRTUAL_MEMORY_H
+#define VIRTUAL_MEMORY_H
+
+#include <iostream>
+#include <vector>
+#include <unordered_set>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+#include "sim_log.h"
+#include "metrics.h"
+#include "cache.h"
+
+// ================= TLB =================
+
+// Fully associative, LRU translation cache of page numbers
+class Tlb {
+private:
+    struct Entry {
+        bool valid;
+        size_t page;
+        size_t stamp;
+        Entry() : valid(false), page(0), stamp(0) {}
+    };
+
+    std::vector<Entry> entries;
+    size_t clock;
+
+public:
+    size_t hits, misses;
+
+    explicit Tlb(size_t n) : entries(n), clock(0), hits(0), misses(0) {}
+
+    bool lookup(size_t page) {
+        clock++;
+        metric_count(M_TLB_ACCESSES);
+
+        for (auto &e : entries) {
+            if (e.valid && e.page == page) {
+                e.stamp = clock;
+                hits++;
+                return true;
+            }
+        }
+
+        misses++;
+        metric_count(M_TLB_MISSES);
+        return false;
+    }
+
+    void insert(size_t page) {
+        Entry *victim = &entries[0];
+        for (auto &e : entries) {
+            if (!e.valid) {
+                victim = &e;
+                break;
+            }
+            if (e.stamp < victim->stamp)
+                victim = &e;
+        }
+
+        victim->valid = true;
+        victim->page = page;
+        victim->stamp = clock;
+    }
+
+    // Shootdown when the page leaves memory
+    void invalidate(size_t page) {
+        for (auto &e : entries) {
+            if (e.valid && e.page == page)
+                e.valid = false;
+        }
+    }
+
+    double hitRate() const {
+        size_t total = hits + misses;
+        return total ? (double)hits / total : 0.0;
+    }
+
+    void checkpoint(SnapshotWriter &w) const {
+        w.put<uint64_t>(clock);
+        w.put<uint64_t>(hits);
+        w.put<uint64_t>(misses);
+        w.putVector(entries);
+    }
+
+    bool restore(SectionCursor &cur) {
+        uint64_t c = 0, h = 0, m = 0;
+        std::vector<Entry> saved;
+        if (!cur.get(c) || !cur.get(h) || !cur.get(m) || !cur.getVector(saved)
+            || saved.size() != entries.size())
+            return false;
+
+        entries.swap(saved);
+        clock = c;
+        hits = h;
+        misses = m;
+        return true;
+    }
+};
+
+// ================= VIRTUAL MEMORY =================
+
+struct PageEntry {
+    bool valid;
+    size_t frame;
+    size_t time;
+    PageEntry() : valid(false), frame(0), time(0) {}
+};
+
+class VirtualMemory {
+public:
+    size_t pageSize, pages, frames;
+    std::vector<PageEntry> table;
+    std::vector<int> frameMap;
+    std::unordered_set<size_t> disk;
+    size_t clock, hits, faults;
+    size_t lastFault;   // clock of the previous fault
+
+    Tlb tlb;
+    CacheHierarchy cache;
+
+    VirtualMemory(size_t vSize, size_t pSize, size_t pSizePg, size_t tlbEntries = 16)
+        : pageSize(pSizePg), clock(0), hits(0), faults(0), lastFault(0),
+          tlb(tlbEntries) {
+        cache.logPrefix = "    Cache: ";
+
+        pages  = vSize / pageSize;
+        frames = pSize / pageSize;
+
+        table.resize(pages);
+        frameMap.resize(frames, -1);
+
+        for (size_t i = 0; i < pages; i++)
+            disk.insert(i);
+    }
+
+    // Virtual to physical, paging the page in on a fault
+    size_t translate(size_t va) {
+        clock++;
+        metric_count(M_PAGE_ACCESSES);
+
+        size_t page = va / pageSize;
+        size_t off  = va % pageSize;
+
+        SIM_LOG << "VA " << va << " → ";
+
+        if (tlb.lookup(page)) {
+            hits++;
+            table[page].time = clock;
+            size_t pa = table[page].frame * pageSize + off;
+            SIM_LOG << "PA " << pa << " (TLB HIT)\n";
+            return pa;
+        }
+
+        if (table[page].valid) {
+            hits++;
+            table[page].time = clock;
+            tlb.insert(page);
+            size_t pa = table[page].frame * pageSize + off;
+            SIM_LOG << "PA " << pa << " (PAGE HIT)\n";
+            return pa;
+        }
+
+        faults++;
+        metric_count(M_PAGE_FAULTS);
+        metric_record(H_FAULT_INTERARRIVAL, clock - lastFault);
+        lastFault = clock;
+        SIM_LOG << "PAGE FAULT\n";
+
+        for (size_t f = 0; f < frames; f++) {
+            if (frameMap[f] == -1) {
+                page_in(page, f);
+                tlb.insert(page);
+                return f * pageSize + off;
+            }
+        }
+
+        size_t victim = select_victim();
+        size_t frame  = table[victim].frame;
+
+        page_out(victim);
+        page_in(page, frame);
+        tlb.insert(page);
+
+        SIM_LOG << "    Replaced page " << victim
+                << " with page " << page << "\n";
+        return frame * pageSize + off;
+    }
+
+    void access(size_t va) {
+        cache.access(translate(va));
+    }
+
+    // TLB, page table and the attached caches. Sizes must match the
+    // snapshot; the disk set is rebuilt from the page table. A failed
+    // restore leaves the VM untouched.
+    void checkpoint(SnapshotWriter &w) const {
+        w.section(SEC_VM);
+        w.put<uint64_t>(pageSize);
+        w.put<uint64_t>(pages);
+        w.put<uint64_t>(frames);
+        w.put<uint64_t>(clock);
+        w.put<uint64_t>(hits);
+        w.put<uint64_t>(faults);
+        w.put<uint64_t>(lastFault);
+        w.putVector(table);
+        w.putVector(frameMap);
+        tlb.checkpoint(w);
+        cache.checkpoint(w);
+    }
+
+    bool restore(const SnapshotReader &r) {
+        SectionCursor cur;
+        uint64_t pSize = 0, nPages = 0, nFrames = 0, c = 0, h = 0, f = 0, lf = 0;
+
+        if (!r.section(SEC_VM, cur) || !cur.get(pSize) || !cur.get(nPages)
+            || !cur.get(nFrames) || pSize != pageSize || nPages != pages
+            || nFrames != frames)
+            return false;
+
+        cur.get(c);
+        cur.get(h);
+        cur.get(f);
+        cur.get(lf);
+
+        // the TLB is parsed into a copy: a damaged cache tail must not
+        // leave it half restored
+        std::vector<PageEntry> savedTable;
+        std::vector<int> savedFrames;
+        Tlb savedTlb = tlb;
+        if (!cur.getVector(savedTable) || !cur.getVector(savedFrames)
+            || savedTable.size() != pages || savedFrames.size() != frames
+            || !savedTlb.restore(cur) || !cache.restore(cur))
+            return false;
+
+        tlb = std::move(savedTlb);
+        table.swap(savedTable);
+        frameMap.swap(savedFrames);
+        clock = c;
+        hits = h;
+        faults = f;
+        lastFault = lf;
+
+        disk.clear();
+        for (size_t p = 0; p < pages; p++) {
+            if (!table[p].valid)
+                disk.insert(p);
+        }
+        return true;
+    }
+
+    void stats() {
+        std::cout << "\n--- Virtual Memory Summary ---\n";
+        std::cout << "Page Hits   : " << hits << "\n";
+        std::cout << "Page Faults: " << faults << "\n";
+        std::cout << "Pages on Disk: " << disk.size() << "\n";
+        std::cout << "TLB Hits    : " << tlb.hits << "\n";
+        std::cout << "TLB Misses  : " << tlb.misses << "\n";
+        std::cout << "TLB Hit Rate: " << tlb.hitRate() * 100 << "%\n";
+    }
+
+private:
+    void page_in(size_t p, size_t f) {
+        disk.erase(p);
+        table[p].valid = true;
+        table[p].frame = f;
+        table[p].time = clock;
+        frameMap[f] = p;
+        SIM_LOG << "    PAGE IN  : Disk → Memory (page " << p << ")\n";
+    }
+
+    void page_out(size_t p) {
+        size_t f = table[p].frame;
+        table[p].valid = false;
+        frameMap[f] = -1;
+        tlb.invalidate(p);
+        disk.insert(p);
+        SIM_LOG << "    PAGE OUT : Memory → Disk (page " << p << ")\n";
+    }
+
+    size_t select_victim() {
+        size_t v = 0, t = SIZE_MAX;
+        for (size_t i = 0; i < table.size(); i++) {
+            if (table[i].valid && table[i].time < t) {
+                t = table[i].time;
+                v = i;
+            }
+        }
+        return v;
+    }
+};
+
+#endif
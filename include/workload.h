@@ -0,0 +1,278 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ SYNTHETIC WORKLOAD GENERATOR
+ ----------------------------
+ - Seeded xoshiro256** generator: same seed, same workload
+ - Allocation streams: power-law, bimodal or phase-changing sizes
+   with short-lived / long-lived / immortal object lifetimes
+ - Address streams: Zipfian hot set, sequential scan, strided
+   (column walk of a row-major matrix) and pointer chasing
+ - Address batches are handed to a consumer thread through a
+   bounded single-producer single-consumer queue
+*/
+
+// ---------- Deterministic RNG ----------
+
+inline uint64_t splitmix64(uint64_t &s) {
+    uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+class Rng {
+private:
+    uint64_t s[4];
+
+    static inline uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    explicit Rng(uint64_t seed = 1) {
+        for (auto &word : s)
+            word = splitmix64(seed);
+    }
+
+    // xoshiro256**
+    inline uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1)
+    inline double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Uniform in [0, n) without a division
+    inline uint64_t below(uint64_t n) {
+        return (uint64_t)(((unsigned __int128)next() * n) >> 64);
+    }
+};
+
+// ---------- Allocation workloads ----------
+
+enum class SizeDist {
+    POWER_LAW,    // Pareto tail: many small requests, a few huge ones
+    BIMODAL,      // small objects mixed with large buffers
+    PHASED        // power-law, bimodal and large-buffer phases in turn
+};
+
+struct AllocSpec {
+    SizeDist dist = SizeDist::POWER_LAW;
+    uint64_t seed = 1;
+    size_t minSize = 16;
+    size_t maxSize = 4096;
+    double alpha = 1.2;              // power-law tail exponent
+    double smallFraction = 0.9;      // bimodal: share of small requests
+    size_t phaseLength = 10000;      // allocations per phase
+    double immortalFraction = 0.05;  // never freed
+    double shortFraction = 0.8;      // of the mortal objects
+    size_t shortLifetime = 16;       // mean, in allocations
+};
+
+struct AllocEvent {
+    bool isFree;
+    uint32_t slot;    // n-th allocation of the workload
+    size_t size;      // request size (malloc only)
+};
+
+// Lifetimes are counted in allocations and capped by the timing
+// wheel, so every event is O(1) to produce.
+class AllocWorkload {
+private:
+    static const size_t WHEEL_SLOTS = 4096;
+
+    AllocSpec spec;
+    Rng rng;
+    std::vector<std::vector<uint32_t>> wheel;
+    uint64_t tick;
+    uint32_t nextSlot;
+
+    size_t drawSize();
+    size_t drawLifetime();
+
+public:
+    explicit AllocWorkload(const AllocSpec &s);
+    AllocEvent next();
+    uint64_t allocations() const { return nextSlot; }
+};
+
+bool parse_size_dist(const std::string &name, SizeDist &dist);
+
+// ---------- Address streams ----------
+
+enum class AddressPattern {
+    ZIPF,           // skewed popularity over the footprint (alias table)
+    SEQUENTIAL,     // linear scan, wraps at the end of the footprint
+    STRIDED,        // walks one column of a row-major matrix at a time
+    POINTER_CHASE   // follows a random single-cycle permutation
+};
+
+struct StreamSpec {
+    AddressPattern pattern = AddressPattern::ZIPF;
+    uint64_t seed = 1;
+    size_t footprint = 1 << 20;   // bytes covered by the stream
+    size_t elemSize = 64;         // bytes per element / node
+    double zipfSkew = 0.99;
+    size_t rowBytes = 4096;       // STRIDED: matrix row length
+};
+
+class AddressStream {
+private:
+    StreamSpec spec;
+    Rng rng;
+    size_t elems;
+    size_t cursor;
+
+    // ZIPF: Vose alias table, one word per column: the 32-bit
+    // threshold in the low half, the alias in the high half
+    std::vector<uint64_t> alias;
+
+    // STRIDED
+    size_t rows, cols, row, col;
+
+    // POINTER_CHASE: Sattolo permutation
+    std::vector<uint32_t> chase;
+
+public:
+    explicit AddressStream(const StreamSpec &s);
+
+    // Writes n addresses, returns n
+    size_t fill(uint64_t *out, size_t n);
+    size_t elements() const { return elems; }
+};
+
+bool parse_address_pattern(const std::string &name, AddressPattern &pattern);
+
+// ---------- Bounded SPSC queue ----------
+
+// Lock-free ring of preallocated slots. The producer fills a slot in
+// place and publishes it, the consumer reads it in place and releases
+// it; each side caches the other's index to keep the shared cache
+// lines quiet.
+template <typename T>
+class SpscQueue {
+private:
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> tail;   // written by the producer
+    size_t cachedHead;
+    alignas(64) std::atomic<size_t> head;   // written by the consumer
+    size_t cachedTail;
+    alignas(64) std::atomic<bool> closed;
+
+public:
+    // capacity must be a power of two
+    explicit SpscQueue(size_t capacity)
+        : slots(new T[capacity]), mask(capacity - 1),
+          tail(0), cachedHead(0), head(0), cachedTail(0), closed(false) {}
+
+    T *writeSlot() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask)
+                return nullptr;
+        }
+        return &slots[t & mask];
+    }
+
+    void publish() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    }
+
+    T *readSlot() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail)
+                return nullptr;
+        }
+        return &slots[h & mask];
+    }
+
+    void release() {
+        head.store(head.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    }
+
+    void close() { closed.store(true, std::memory_order_release); }
+    bool isClosed() const { return closed.load(std::memory_order_acquire); }
+};
+
+// ---------- Live feed ----------
+
+static const size_t WORKLOAD_BATCH = 1024;        // addresses per queue slot
+static const size_t WORKLOAD_QUEUE_DEPTH = 16;    // slots in flight
+
+struct AddressBatch {
+    size_t count;
+    uint64_t addrs[WORKLOAD_BATCH];
+};
+
+// Generates `events` addresses on a producer thread and calls
+// sink(addrs, count) for each batch on the calling thread.
+// Returns the number of addresses consumed.
+template <typename Sink>
+uint64_t feed_stream(AddressStream &stream, uint64_t events, Sink sink) {
+    SpscQueue<AddressBatch> queue(WORKLOAD_QUEUE_DEPTH);
+
+    std::thread producer([&] {
+        uint64_t left = events;
+        while (left > 0) {
+            AddressBatch *b;
+            while (!(b = queue.writeSlot()))
+                std::this_thread::yield();
+
+            b->count = stream.fill(b->addrs, (size_t)std::min<uint64_t>(left, WORKLOAD_BATCH));
+            left -= b->count;
+            queue.publish();
+        }
+        queue.close();
+    });
+
+    uint64_t consumed = 0;
+    while (true) {
+        AddressBatch *b = queue.readSlot();
+        if (!b) {
+            // the final publish happens before close, so re-check once
+            if (queue.isClosed() && !(b = queue.readSlot()))
+                break;
+            if (!b) {
+                std::this_thread::yield();
+                continue;
+            }
+        }
+
+        sink(b->addrs, b->count);
+        consumed += b->count;
+        queue.release();
+    }
+
+    producer.join();
+    return consumed;
+}
+
+#endif
@@ -1,7 +1,12 @@
 #include <iostream>
 #include <vector>
 #include <limits>
+#include <algorithm>
+#include <string>
 #include "../../include/block.h"
+#include "../../include/fragmentation.h"
+#include "../../include/sim_log.h"
+#include "../../include/snapshot.h"
 
 using namespace std;
 
@@ -14,6 +19,39 @@ static int NEXT_ID = 1;
 static int success_count = 0;
 static int failure_count = 0;
 
+// Compaction: ids are handles, so blocks may move freely.
+// Pause model: fixed cost per moved block plus copy bandwidth.
+enum class CompactionPolicy { OFF, FULL, INCREMENTAL, CHEAPEST };
+
+static CompactionPolicy AUTO_COMPACTION = CompactionPolicy::OFF;
+static size_t PAUSE_BUDGET = 256;          // bytes per incremental pause
+static const size_t MOVE_SETUP_CYCLES = 50;
+static const size_t COPY_BYTES_PER_CYCLE = 8;
+
+static int compaction_runs = 0;
+static size_t compaction_blocks = 0;
+static size_t compaction_bytes = 0;
+static size_t compaction_pause_total = 0;
+static size_t compaction_pause_max = 0;
+static double compaction_frag_reduced = 0.0;
+
+static int realloc_in_place_grow = 0;
+static int realloc_in_place_shrink = 0;
+static int realloc_moved = 0;
+static size_t realloc_copy_bytes = 0;
+
+// Overhead model: every block carries an in-band header and no block
+// (or leftover free fragment) may be smaller than MIN_BLOCK.
+static size_t HEADER_SIZE = 0;
+static size_t MIN_BLOCK = 1;
+
+// Where a request lands inside a free segment
+struct Placement {
+    size_t lead;      // free bytes left in front (alignment gap)
+    size_t size;      // block footprint, header and slack included
+    size_t payload;   // aligned payload address
+};
+
 /* ================= INTERNAL HELPERS ================= */
 
 // Rebuilds memory by merging all adjacent free blocks
@@ -36,22 +74,67 @@ static void coalesce_free_segments() {
     segments = merged;
 }
 
-// Generic allocator used by all strategies
-static int allocate_using_index(int index, size_t req) {
-    int id = NEXT_ID++;
+static size_t align_up(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+// Computes the block layout for req/align behind a `header`-byte
+// header at the start of seg. Gaps too small to stand alone as free
+// blocks are absorbed.
+static bool place(const Block &seg, size_t req, size_t align, size_t header,
+                  Placement &p) {
+    size_t payload = align_up(seg.start + header, align);
+    size_t lead = payload - header - seg.start;
+
+    if (lead < MIN_BLOCK)
+        lead = 0;
+
+    size_t size = payload + req - (seg.start + lead);
+    if (size < MIN_BLOCK)
+        size = MIN_BLOCK;
+
+    if (lead + size > seg.size)
+        return false;
+
+    size_t tail = seg.size - lead - size;
+    if (tail > 0 && tail < MIN_BLOCK)
+        size += tail;
+
+    p.lead = lead;
+    p.size = size;
+    p.payload = payload;
+    return true;
+}
+
+// Carves block `id` out of free segment `index`; returns its new index
+static int place_at(int index, size_t req, size_t align, size_t header, int id) {
+    Placement p;
+    place(segments[index], req, align, header, p);
+
+    if (p.lead > 0) {
+        Block gap(segments[index].start, p.lead, true, -1);
+        segments[index].start += p.lead;
+        segments[index].size -= p.lead;
+        segments.insert(segments.begin() + index, gap);
+        index++;
+    }
 
     Block &target = segments[index];
 
-    size_t remaining = target.size - req;
+    size_t remaining = target.size - p.size;
     size_t base_addr = target.start;
 
-    target.size = req;
+    target.size = p.size;
     target.free = false;
     target.id = id;
+    target.payload = p.payload;
+    target.requested = req;
+    target.align = align;
+    target.header = header;
 
     if (remaining > 0) {
         Block tail(
-            base_addr + req,
+            base_addr + p.size,
             remaining,
             true,
             -1
@@ -59,6 +142,14 @@ static int allocate_using_index(int index, size_t req) {
         segments.insert(segments.begin() + index + 1, tail);
     }
 
+    return index;
+}
+
+// Generic allocator used by all strategies
+static int allocate_using_index(int index, size_t req, size_t align) {
+    int id = NEXT_ID++;
+    place_at(index, req, align, HEADER_SIZE, id);
+
     success_count++;
     return id;
 }
@@ -71,36 +162,97 @@ void init_memory(size_t size) {
     NEXT_ID = 1;
     success_count = 0;
     failure_count = 0;
+    realloc_in_place_grow = 0;
+    realloc_in_place_shrink = 0;
+    realloc_moved = 0;
+    realloc_copy_bytes = 0;
+    compaction_runs = 0;
+    compaction_blocks = 0;
+    compaction_bytes = 0;
+    compaction_pause_total = 0;
+    compaction_pause_max = 0;
+    compaction_frag_reduced = 0.0;
 
     segments.emplace_back(0, size, true, -1);
 
-    cout << "[INIT] Memory initialized with " << size << " units\n";
+    SIM_LOG << "[INIT] Memory initialized with " << size << " units\n";
+}
+
+// Replaces the heap with a prebuilt layout (benchmark setup)
+void fit_load_segments(const vector<Block> &layout, size_t totalMemory) {
+    segments = layout;
+    TOTAL_MEMORY = totalMemory;
+    NEXT_ID = 1;
+
+    for (auto &seg : segments)
+        NEXT_ID = max(NEXT_ID, seg.id + 1);
+}
+
+void set_block_overhead(size_t header, size_t minBlock) {
+    HEADER_SIZE = header;
+    MIN_BLOCK = minBlock ? minBlock : 1;
+
+    SIM_LOG << "[INFO] Block header " << HEADER_SIZE
+            << ", minimum block " << MIN_BLOCK << "\n";
+}
+
+/* ---------------- STRATEGY DRIVER ---------------- */
+
+static bool auto_compact(size_t req);
+
+typedef int (*FitSearch)(size_t, size_t);
+
+// Runs a placement search, retrying once after auto-compaction;
+// returns the chosen free segment or -1
+static int fit_search(FitSearch find, size_t req, size_t align) {
+    int chosen = find(req, align);
+
+    if (chosen == -1 && auto_compact(req))
+        chosen = find(req, align);
+
+    return chosen;
+}
+
+static int fit_malloc(const char *tag, FitSearch find, size_t req, size_t align) {
+    int chosen = fit_search(find, req, align);
+
+    if (chosen == -1) {
+        failure_count++;
+        SIM_LOG << "[" << tag << "] Allocation failed\n";
+        return -1;
+    }
+
+    int id = allocate_using_index(chosen, req, align);
+    SIM_LOG << "[" << tag << "] Allocated block " << id << "\n";
+    return id;
 }
 
 /* ---------------- FIRST FIT ---------------- */
 
-int first_fit_malloc(size_t req) {
+static int find_first_fit(size_t req, size_t align) {
+    Placement p;
+
     for (size_t i = 0; i < segments.size(); i++) {
-        if (segments[i].free && segments[i].size >= req) {
-            int id = allocate_using_index(i, req);
-            cout << "[FIRST FIT] Allocated block " << id << "\n";
-            return id;
-        }
+        if (segments[i].free && place(segments[i], req, align, HEADER_SIZE, p))
+            return i;
     }
 
-    failure_count++;
-    cout << "[FIRST FIT] Allocation failed\n";
     return -1;
 }
 
+int first_fit_malloc(size_t req, size_t align) {
+    return fit_malloc("FIRST FIT", find_first_fit, req, align);
+}
+
 /* ---------------- BEST FIT ---------------- */
 
-int best_fit_malloc(size_t req) {
+static int find_best_fit(size_t req, size_t align) {
     int chosen = -1;
     size_t best_size = numeric_limits<size_t>::max();
+    Placement p;
 
     for (size_t i = 0; i < segments.size(); i++) {
-        if (segments[i].free && segments[i].size >= req) {
+        if (segments[i].free && place(segments[i], req, align, HEADER_SIZE, p)) {
             if (segments[i].size < best_size) {
                 best_size = segments[i].size;
                 chosen = i;
@@ -108,25 +260,22 @@ int best_fit_malloc(size_t req) {
         }
     }
 
-    if (chosen == -1) {
-        failure_count++;
-        cout << "[BEST FIT] Allocation failed\n";
-        return -1;
-    }
+    return chosen;
+}
 
-    int id = allocate_using_index(chosen, req);
-    cout << "[BEST FIT] Allocated block " << id << "\n";
-    return id;
+int best_fit_malloc(size_t req, size_t align) {
+    return fit_malloc("BEST FIT", find_best_fit, req, align);
 }
 
 /* ---------------- WORST FIT ---------------- */
 
-int worst_fit_malloc(size_t req) {
+static int find_worst_fit(size_t req, size_t align) {
     int chosen = -1;
     size_t worst_size = 0;
+    Placement p;
 
     for (size_t i = 0; i < segments.size(); i++) {
-        if (segments[i].free && segments[i].size >= req) {
+        if (segments[i].free && place(segments[i], req, align, HEADER_SIZE, p)) {
             if (segments[i].size > worst_size) {
                 worst_size = segments[i].size;
                 chosen = i;
@@ -134,38 +283,357 @@ int worst_fit_malloc(size_t req) {
         }
     }
 
-    if (chosen == -1) {
-        failure_count++;
-        cout << "[WORST FIT] Allocation failed\n";
-        return -1;
-    }
+    return chosen;
+}
 
-    int id = allocate_using_index(chosen, req);
-    cout << "[WORST FIT] Allocated block " << id << "\n";
-    return id;
+int worst_fit_malloc(size_t req, size_t align) {
+    return fit_malloc("WORST FIT", find_worst_fit, req, align);
 }
 
 /* ---------------- FREE ---------------- */
 
+static void release_segment(Block &seg) {
+    seg.free = true;
+    seg.id = -1;
+    seg.payload = seg.start;
+    seg.requested = 0;
+    seg.header = 0;
+}
+
 void free_block(int id) {
     bool found = false;
 
     for (auto &seg : segments) {
         if (!seg.free && seg.id == id) {
-            seg.free = true;
-            seg.id = -1;
+            release_segment(seg);
             found = true;
             break;
         }
     }
 
     if (!found) {
-        cout << "[FREE] Invalid block id\n";
+        SIM_LOG << "[FREE] Invalid block id\n";
         return;
     }
 
     coalesce_free_segments();
-    cout << "[FREE] Block " << id << " released\n";
+    SIM_LOG << "[FREE] Block " << id << " released\n";
+}
+
+/* ---------------- REALLOC ---------------- */
+
+static int find_block(int id) {
+    for (size_t i = 0; i < segments.size(); i++) {
+        if (!segments[i].free && segments[i].id == id)
+            return i;
+    }
+    return -1;
+}
+
+// Payload address of a live block, SIZE_MAX if the id is unknown
+size_t fit_block_address(int id) {
+    int index = find_block(id);
+    return index == -1 ? SIZE_MAX : segments[index].payload;
+}
+
+// Resizes block `id`, keeping its id as the handle. Shrinks and grows
+// in place when possible; otherwise the strategy of `fallback` places
+// a new block with the old alignment, the payload is copied and the
+// old block is freed. A move is one realloc: it takes no new id and
+// is not counted as an allocation.
+int realloc_block(int id, size_t newSize, int (*fallback)(size_t, size_t)) {
+    int index = find_block(id);
+    if (index == -1) {
+        SIM_LOG << "[REALLOC] Invalid block id\n";
+        return -1;
+    }
+
+    Block &b = segments[index];
+    size_t end = b.start + b.size;
+    size_t need = max(b.payload + newSize - b.start, MIN_BLOCK);
+
+    /* ---- shrink (or fits in existing slack) ---- */
+    if (need <= b.size) {
+        size_t tail = b.size - need;
+        b.requested = newSize;
+
+        if (tail >= MIN_BLOCK) {
+            b.size = need;
+            segments.insert(segments.begin() + index + 1,
+                            Block(b.start + need, tail, true, -1));
+            coalesce_free_segments();
+        }
+
+        realloc_in_place_shrink++;
+        SIM_LOG << "[REALLOC] Block " << id << " resized in place to "
+                << newSize << "\n";
+        return id;
+    }
+
+    /* ---- grow into the following free segment ---- */
+    size_t extra = need - b.size;
+
+    if (index + 1 < (int)segments.size() && segments[index + 1].free
+        && segments[index + 1].size >= extra) {
+        Block &next = segments[index + 1];
+        size_t left = next.size - extra;
+
+        if (left < MIN_BLOCK) {
+            b.size += next.size;
+            segments.erase(segments.begin() + index + 1);
+        } else {
+            b.size += extra;
+            next.start += extra;
+            next.size = left;
+        }
+
+        segments[index].requested = newSize;
+        realloc_in_place_grow++;
+        SIM_LOG << "[REALLOC] Block " << id << " grown in place to "
+                << newSize << " (end 0x" << hex << end + extra << dec << ")\n";
+        return id;
+    }
+
+    /* ---- allocate, copy, free ---- */
+    size_t oldRequested = b.requested;
+    size_t oldAlign = b.align;
+
+    FitSearch find = fallback == best_fit_malloc ? find_best_fit
+                   : fallback == worst_fit_malloc ? find_worst_fit
+                   : find_first_fit;
+
+    int chosen = fit_search(find, newSize, oldAlign);
+    if (chosen == -1) {
+        SIM_LOG << "[REALLOC] Block " << id << " unchanged (no space)\n";
+        return -1;
+    }
+
+    // auto-compaction may have slid the old block, so look it up again
+    size_t oldStart = segments[find_block(id)].start;
+    place_at(chosen, newSize, oldAlign, HEADER_SIZE, id);
+
+    for (auto &seg : segments) {
+        if (!seg.free && seg.id == id && seg.start == oldStart) {
+            release_segment(seg);
+            break;
+        }
+    }
+    coalesce_free_segments();
+
+    realloc_moved++;
+    realloc_copy_bytes += min(oldRequested, newSize);
+
+    SIM_LOG << "[REALLOC] Block " << id << " moved, copied "
+            << min(oldRequested, newSize) << " units\n";
+    return id;
+}
+
+/* ---------------- COMPACTION ---------------- */
+
+FragSample fit_frag_sample();
+
+struct CompactionRun {
+    size_t blocks;
+    size_t bytes;
+};
+
+static size_t pause_cycles(const CompactionRun &run) {
+    return run.blocks * MOVE_SETUP_CYCLES + run.bytes / COPY_BYTES_PER_CYCLE;
+}
+
+static size_t moved_bytes(const Block &b) {
+    return b.requested + b.header;
+}
+
+// Slides used block i down into the free segment in front of it.
+// The hole left behind is merged with a following free segment.
+static bool slide_down(int i, CompactionRun &run) {
+    Block hole = segments[i - 1];
+    Block blk = segments[i];
+
+    Block region(hole.start, hole.size + blk.size, true, -1);
+    Placement p;
+    place(region, blk.requested, blk.align, blk.header, p);
+
+    if (p.payload >= blk.payload)
+        return false;
+
+    vector<Block> moved;
+    if (p.lead > 0)
+        moved.emplace_back(hole.start, p.lead, true, -1);
+
+    blk.start = hole.start + p.lead;
+    blk.size = p.size;
+    blk.payload = p.payload;
+    moved.push_back(blk);
+
+    size_t rest = region.size - p.lead - p.size;
+    bool mergeNext = i + 1 < (int)segments.size() && segments[i + 1].free;
+
+    if (rest > 0 || mergeNext) {
+        Block tail(blk.start + blk.size, rest, true, -1);
+        if (mergeNext)
+            tail.size += segments[i + 1].size;
+        moved.push_back(tail);
+    }
+
+    int last = mergeNext ? i + 2 : i + 1;
+    segments.erase(segments.begin() + i - 1, segments.begin() + last);
+    segments.insert(segments.begin() + i - 1, moved.begin(), moved.end());
+
+    run.blocks++;
+    run.bytes += moved_bytes(blk);
+    return true;
+}
+
+// Slides blocks toward address 0 until `budget` bytes have moved
+static CompactionRun slide_compact(size_t budget) {
+    CompactionRun run = {0, 0};
+
+    for (size_t i = 1; i < segments.size(); i++) {
+        if (segments[i].free || !segments[i - 1].free)
+            continue;
+
+        if (run.blocks > 0 && run.bytes + moved_bytes(segments[i]) > budget)
+            break;
+
+        slide_down(i, run);
+    }
+
+    return run;
+}
+
+// Moves blocks whose removal opens the biggest hole per byte copied
+// into other holes, until a hole of `target` bytes exists.
+static CompactionRun cheapest_compact(size_t target) {
+    CompactionRun run = {0, 0};
+
+    while (fit_frag_sample().largestFree < target) {
+        size_t largest = fit_frag_sample().largestFree;
+        int bestBlock = -1, bestHole = -1;
+        double bestScore = 0.0;
+
+        for (int i = 0; i < (int)segments.size(); i++) {
+            const Block &b = segments[i];
+            if (b.free)
+                continue;
+
+            size_t opened = b.size;
+            if (i > 0 && segments[i - 1].free)
+                opened += segments[i - 1].size;
+            if (i + 1 < (int)segments.size() && segments[i + 1].free)
+                opened += segments[i + 1].size;
+
+            if (opened <= largest)
+                continue;
+
+            double score = (double)opened / moved_bytes(b);
+            if (score <= bestScore)
+                continue;
+
+            Placement p;
+            for (int j = 0; j < (int)segments.size(); j++) {
+                if (!segments[j].free || j == i - 1 || j == i + 1)
+                    continue;
+                if (place(segments[j], b.requested, b.align, b.header, p)) {
+                    bestScore = score;
+                    bestBlock = i;
+                    bestHole = j;
+                    break;
+                }
+            }
+        }
+
+        if (bestBlock == -1)
+            break;
+
+        Block b = segments[bestBlock];
+        release_segment(segments[bestBlock]);
+        place_at(bestHole, b.requested, b.align, b.header, b.id);
+        coalesce_free_segments();
+
+        run.blocks++;
+        run.bytes += moved_bytes(b);
+    }
+
+    return run;
+}
+
+static CompactionRun run_compaction(CompactionPolicy policy, size_t arg,
+                                    const char *tag) {
+    double before = external_fragmentation(fit_frag_sample());
+
+    CompactionRun run = {0, 0};
+    if (policy == CompactionPolicy::FULL)
+        run = slide_compact(numeric_limits<size_t>::max());
+    else if (policy == CompactionPolicy::INCREMENTAL)
+        run = slide_compact(arg);
+    else if (policy == CompactionPolicy::CHEAPEST)
+        run = cheapest_compact(arg);
+
+    double after = external_fragmentation(fit_frag_sample());
+    size_t pause = pause_cycles(run);
+
+    compaction_runs++;
+    compaction_blocks += run.blocks;
+    compaction_bytes += run.bytes;
+    compaction_pause_total += pause;
+    compaction_pause_max = max(compaction_pause_max, pause);
+    compaction_frag_reduced += before - after;
+
+    SIM_LOG << "[COMPACT " << tag << "] moved " << run.blocks << " blocks ("
+            << run.bytes << " units), pause " << pause << " cycles, "
+            << "external frag " << before * 100 << "% -> " << after * 100 << "%\n";
+    return run;
+}
+
+// Called when a strategy finds no hole although enough memory is free
+static bool auto_compact(size_t req) {
+    if (AUTO_COMPACTION == CompactionPolicy::OFF)
+        return false;
+
+    FragSample s = fit_frag_sample();
+    if (s.freeBytes < req + HEADER_SIZE)
+        return false;
+
+    CompactionRun run = run_compaction(AUTO_COMPACTION,
+        AUTO_COMPACTION == CompactionPolicy::CHEAPEST ? req + HEADER_SIZE
+                                                      : PAUSE_BUDGET,
+        "AUTO");
+    return run.blocks > 0;
+}
+
+void compact_full() {
+    run_compaction(CompactionPolicy::FULL, 0, "FULL");
+}
+
+void compact_step(size_t budget) {
+    run_compaction(CompactionPolicy::INCREMENTAL,
+                   budget ? budget : PAUSE_BUDGET, "STEP");
+}
+
+void compact_cheapest(size_t target) {
+    run_compaction(CompactionPolicy::CHEAPEST, target, "CHEAPEST");
+}
+
+bool set_auto_compaction(const string &policy, size_t budget) {
+    if (policy == "off")
+        AUTO_COMPACTION = CompactionPolicy::OFF;
+    else if (policy == "full")
+        AUTO_COMPACTION = CompactionPolicy::FULL;
+    else if (policy == "incremental")
+        AUTO_COMPACTION = CompactionPolicy::INCREMENTAL;
+    else if (policy == "cheapest")
+        AUTO_COMPACTION = CompactionPolicy::CHEAPEST;
+    else
+        return false;
+
+    if (budget > 0)
+        PAUSE_BUDGET = budget;
+
+    SIM_LOG << "[INFO] Auto compaction: " << policy
+            << " (pause budget " << PAUSE_BUDGET << " units)\n";
+    return true;
 }
 
 /* ---------------- DUMP ---------------- */
@@ -180,18 +648,152 @@ void dump_memory() {
         if (seg.free)
             cout << "FREE\n";
         else
-            cout << "USED (id=" << dec << seg.id << ")\n";
+            cout << "USED (id=" << dec << seg.id
+                 << ", payload=0x" << hex << seg.payload
+                 << ", req=" << dec << seg.requested << ")\n";
     }
 
     cout << dec;
 }
 
+/* ---------------- CHECKPOINT ---------------- */
+
+struct FitCheckpoint {
+    uint64_t totalMemory;
+    int64_t nextId, successCount, failureCount;
+    int64_t reallocGrow, reallocShrink, reallocMoved;
+    uint64_t reallocCopyBytes;
+    int64_t compactionRuns;
+    uint64_t compactionBlocks, compactionBytes, pauseTotal, pauseMax;
+    double fragReduced;
+};
+
+void fit_checkpoint(SnapshotWriter &w) {
+    FitCheckpoint c = {
+        TOTAL_MEMORY, NEXT_ID, success_count, failure_count,
+        realloc_in_place_grow, realloc_in_place_shrink, realloc_moved,
+        realloc_copy_bytes, compaction_runs, compaction_blocks,
+        compaction_bytes, compaction_pause_total, compaction_pause_max,
+        compaction_frag_reduced
+    };
+
+    w.section(SEC_FIT);
+    w.put(c);
+    w.putVector(segments);
+}
+
+// Restore is staged: the section is parsed and checked into
+// `staged` first, and the heap only changes on commit, so a damaged
+// snapshot (or a damaged section of another engine) leaves it as is.
+struct FitImage {
+    FitCheckpoint c;
+    vector<Block> segments;
+};
+
+static FitImage staged;
+
+static bool power_of_two(size_t v) {
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+// Segments must tile [0, totalMemory) in order; used blocks need a
+// unique id below nextId and a payload inside the block.
+static bool fit_valid(const FitImage &img) {
+    const FitCheckpoint &c = img.c;
+    if (c.nextId < 1)
+        return false;
+
+    vector<int> ids;
+    size_t expected = 0;
+
+    for (auto &seg : img.segments) {
+        if (seg.start != expected || seg.size == 0 || seg.size > c.totalMemory - expected)
+            return false;
+        expected += seg.size;
+
+        if (seg.free) {
+            if (seg.id != -1)
+                return false;
+            continue;
+        }
+
+        size_t end = seg.start + seg.size;
+        if (seg.id < 1 || seg.id >= c.nextId || !power_of_two(seg.align)
+            || seg.header > seg.size || seg.payload < seg.start + seg.header
+            || seg.payload > end
+            || seg.requested > end - seg.payload)
+            return false;
+        ids.push_back(seg.id);
+    }
+
+    sort(ids.begin(), ids.end());
+    return expected == c.totalMemory
+        && adjacent_find(ids.begin(), ids.end()) == ids.end();
+}
+
+bool fit_restore_stage(const SnapshotReader &r) {
+    SectionCursor cur;
+
+    return r.section(SEC_FIT, cur) && cur.get(staged.c)
+        && cur.getVector(staged.segments) && fit_valid(staged);
+}
+
+// Only after fit_restore_stage() succeeded
+void fit_restore_commit() {
+    const FitCheckpoint &c = staged.c;
+
+    segments.swap(staged.segments);
+    staged.segments.clear();
+    TOTAL_MEMORY = c.totalMemory;
+    NEXT_ID = c.nextId;
+    success_count = c.successCount;
+    failure_count = c.failureCount;
+    realloc_in_place_grow = c.reallocGrow;
+    realloc_in_place_shrink = c.reallocShrink;
+    realloc_moved = c.reallocMoved;
+    realloc_copy_bytes = c.reallocCopyBytes;
+    compaction_runs = c.compactionRuns;
+    compaction_blocks = c.compactionBlocks;
+    compaction_bytes = c.compactionBytes;
+    compaction_pause_total = c.pauseTotal;
+    compaction_pause_max = c.pauseMax;
+    compaction_frag_reduced = c.fragReduced;
+}
+
+// Leaves the heap untouched when the section is missing or damaged
+bool fit_restore(const SnapshotReader &r) {
+    if (!fit_restore_stage(r))
+        return false;
+    fit_restore_commit();
+    return true;
+}
+
 /* ---------------- STATS ---------------- */
 
+FragSample fit_frag_sample() {
+    FragSample s = {TOTAL_MEMORY, 0, 0, 0, 0};
+
+    for (auto &seg : segments) {
+        if (seg.free) {
+            s.freeBytes += seg.size;
+            s.largestFree = max(s.largestFree, seg.size);
+        } else {
+            s.used += seg.size;
+            s.requested += seg.requested;
+        }
+    }
+
+    return s;
+}
+
 void print_stats() {
     size_t used = 0;
     size_t free_mem = 0;
     size_t largest_gap = 0;
+    size_t requested = 0;
+    size_t headers = 0;
+    size_t padding = 0;
+    int blocks = 0;
 
     for (auto &seg : segments) {
         if (seg.free) {
@@ -199,9 +801,15 @@ void print_stats() {
             largest_gap = max(largest_gap, seg.size);
         } else {
             used += seg.size;
+            requested += seg.requested;
+            headers += seg.header;
+            padding += seg.payload - seg.header - seg.start;
+            blocks++;
         }
     }
 
+    size_t wasted = used - requested;
+
     cout << "\n--- Memory Statistics ---\n";
     cout << "Total Memory: " << TOTAL_MEMORY << "\n";
     cout << "Used Memory : " << used << "\n";
@@ -217,7 +825,23 @@ void print_stats() {
         cout << "External Fragmentation: 0%\n";
     }
 
-    cout << "Internal Fragmentation: 0%\n";
+    double internal = used ? (double)wasted / used : 0.0;
+    cout << "Internal Fragmentation: " << internal * 100 << "% ("
+         << wasted << " units)\n";
+    cout << "  Header Overhead : " << headers
+         << " (" << blocks << " blocks, current header " << HEADER_SIZE << ")\n";
+    cout << "  Alignment Pad   : " << padding << "\n";
+    cout << "  Tail Slack      : " << wasted - headers - padding << "\n";
     cout << "Alloc Success: " << success_count << "\n";
     cout << "Alloc Failure: " << failure_count << "\n";
+    cout << "Realloc In-Place Grow  : " << realloc_in_place_grow << "\n";
+    cout << "Realloc In-Place Shrink: " << realloc_in_place_shrink << "\n";
+    cout << "Realloc Moved          : " << realloc_moved
+         << " (" << realloc_copy_bytes << " units copied)\n";
+    cout << "Compactions   : " << compaction_runs << "\n";
+    cout << "  Blocks Moved: " << compaction_blocks << "\n";
+    cout << "  Bytes Moved : " << compaction_bytes << "\n";
+    cout << "  Pause Total : " << compaction_pause_total << " cycles\n";
+    cout << "  Pause Max   : " << compaction_pause_max << " cycles\n";
+    cout << "  Ext. Frag Reduced: " << compaction_frag_reduced * 100 << " pts\n";
 }
@@ -0,0 +1,573 @@
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../../include/arena.h"
+
+/*
+ Block layouts (all sizes multiples of 16, payload 16-aligned):
+
+   fit   used : [Tag][payload ............][footer]
+   fit   free : [Tag][next][prev] ........ [footer]
+   buddy used : [Tag][payload ....................]
+   buddy free : [Tag][next][prev] ................
+
+ Tag.info = block size | flags. An aligned allocation gets an extra
+ ALIAS tag right in front of the aligned pointer, whose size field is
+ the distance back to the real payload.
+*/
+
+/* ================= LAYOUT ================= */
+
+struct Tag {
+    uint64_t info;
+    uint64_t requested;
+};
+
+struct FreeLinks {
+    char *next;
+    char *prev;
+};
+
+static const size_t TAG_SIZE = sizeof(Tag);
+static const size_t FOOTER_SIZE = sizeof(uint64_t);
+static const size_t ARENA_ALIGN = 16;
+static const uint64_t USED = 1;
+static const uint64_t ALIAS = 2;
+static const uint64_t FLAG_MASK = ARENA_ALIGN - 1;
+
+static const size_t FIT_MIN_BLOCK = 48;   // tag + links + footer, rounded
+static const int BUDDY_MIN_ORDER = 5;     // 32 bytes: tag + links
+static const int BUDDY_MAX_ORDER = 47;
+
+/* ================= STATE ================= */
+
+static ArenaStrategy STRATEGY = ArenaStrategy::FIRST_FIT;
+static char *region = nullptr;     // mapping
+static size_t mapSize = 0;
+static size_t regionSize = 0;      // managed bytes (buddy: a power of two)
+static char *heapEnd = nullptr;    // end of the managed part
+
+static char *fitFree = nullptr;    // address-ordered free list
+static char *buddyFree[BUDDY_MAX_ORDER + 1];
+static int buddyTopOrder = 0;
+
+static size_t inUse = 0;
+static size_t requestedBytes = 0;
+static size_t peakInUse = 0;
+static uint64_t mallocCount = 0;
+static uint64_t freeCount = 0;
+static uint64_t failureCount = 0;
+
+/* ================= HELPERS ================= */
+
+static inline Tag *tag_of(char *block) {
+    return reinterpret_cast<Tag *>(block);
+}
+
+static inline size_t block_size(char *block) {
+    return tag_of(block)->info & ~FLAG_MASK;
+}
+
+static inline bool block_used(char *block) {
+    return tag_of(block)->info & USED;
+}
+
+static inline FreeLinks *links_of(char *block) {
+    return reinterpret_cast<FreeLinks *>(block + TAG_SIZE);
+}
+
+static inline size_t round_up(size_t v, size_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+static void list_push(char *&head, char *block) {
+    FreeLinks *l = links_of(block);
+    l->next = head;
+    l->prev = nullptr;
+    if (head)
+        links_of(head)->prev = block;
+    head = block;
+}
+
+// Address-ordered insert, so first fit takes the lowest free block
+static void list_insert_ordered(char *&head, char *block) {
+    char *prev = nullptr;
+    char *next = head;
+    while (next && next < block) {
+        prev = next;
+        next = links_of(next)->next;
+    }
+
+    FreeLinks *l = links_of(block);
+    l->next = next;
+    l->prev = prev;
+    if (prev)
+        links_of(prev)->next = block;
+    else
+        head = block;
+    if (next)
+        links_of(next)->prev = block;
+}
+
+// `block` takes over the list position of `old`
+static void list_replace(char *&head, char *old, char *block) {
+    FreeLinks l = *links_of(old);
+    *links_of(block) = l;
+    if (l.prev)
+        links_of(l.prev)->next = block;
+    else
+        head = block;
+    if (l.next)
+        links_of(l.next)->prev = block;
+}
+
+static void list_unlink(char *&head, char *block) {
+    FreeLinks *l = links_of(block);
+    if (l->prev)
+        links_of(l->prev)->next = l->next;
+    else
+        head = l->next;
+    if (l->next)
+        links_of(l->next)->prev = l->prev;
+}
+
+static void account_alloc(char *block, size_t requested) {
+    tag_of(block)->requested = requested;
+    inUse += block_size(block);
+    requestedBytes += requested;
+    if (inUse > peakInUse)
+        peakInUse = inUse;
+    mallocCount++;
+}
+
+static void account_free(char *block) {
+    inUse -= block_size(block);
+    requestedBytes -= tag_of(block)->requested;
+    freeCount++;
+}
+
+/* ================= FIT STRATEGIES ================= */
+
+static void fit_set(char *block, size_t size, uint64_t flags) {
+    tag_of(block)->info = size | flags;
+    *reinterpret_cast<uint64_t *>(block + size - FOOTER_SIZE) = size | flags;
+}
+
+static char *fit_find(size_t need) {
+    char *best = nullptr;
+
+    for (char *b = fitFree; b; b = links_of(b)->next) {
+        size_t size = block_size(b);
+        if (size < need)
+            continue;
+        if (STRATEGY == ArenaStrategy::FIRST_FIT || size == need)
+            return b;
+        if (!best || size < block_size(best))
+            best = b;
+    }
+    return best;
+}
+
+// Marks `block` used with `need` bytes. `listed` is the free-list node
+// it was taken from: the tail inherits its position, which keeps the
+// list in address order without a walk.
+static void fit_carve(char *block, size_t need, char *listed) {
+    size_t size = block_size(block);
+
+    if (size - need >= FIT_MIN_BLOCK) {
+        char *rest = block + need;
+        list_replace(fitFree, listed, rest);
+        fit_set(block, need, USED);
+        fit_set(rest, size - need, 0);
+    } else {
+        list_unlink(fitFree, listed);
+        fit_set(block, size, USED);
+    }
+}
+
+static char *fit_alloc(size_t need) {
+    char *block = fit_find(need);
+    if (!block)
+        return nullptr;
+
+    fit_carve(block, need, block);
+    return block;
+}
+
+// A merged block reuses a free neighbour's list slot; only a block
+// with no free neighbour needs the ordered insert
+static void fit_release(char *block) {
+    size_t size = block_size(block);
+    char *listed = nullptr;
+
+    char *next = block + size;
+    if (next < heapEnd && !block_used(next)) {
+        size += block_size(next);
+        listed = next;
+    }
+
+    if (block > region) {
+        uint64_t prevInfo = *reinterpret_cast<uint64_t *>(block - FOOTER_SIZE);
+        if (!(prevInfo & USED)) {
+            char *prev = block - (prevInfo & ~FLAG_MASK);
+            if (listed)
+                list_unlink(fitFree, listed);
+            listed = prev;
+            size += prevInfo & ~FLAG_MASK;
+            block = prev;
+        }
+    }
+
+    if (!listed)
+        list_insert_ordered(fitFree, block);
+    else if (listed != block)
+        list_replace(fitFree, listed, block);
+    fit_set(block, size, 0);
+}
+
+static size_t fit_need(size_t size) {
+    size_t need = round_up(size + TAG_SIZE + FOOTER_SIZE, ARENA_ALIGN);
+    return need < FIT_MIN_BLOCK ? FIT_MIN_BLOCK : need;
+}
+
+// Grows into a free successor when it is large enough
+static bool fit_grow_in_place(char *block, size_t need) {
+    size_t size = block_size(block);
+    char *next = block + size;
+
+    if (next >= heapEnd || block_used(next) || size + block_size(next) < need)
+        return false;
+
+    inUse -= size;
+    fit_set(block, size + block_size(next), 0);
+    fit_carve(block, need, next);
+    inUse += block_size(block);
+    if (inUse > peakInUse)
+        peakInUse = inUse;
+    return true;
+}
+
+/* ================= BUDDY STRATEGY ================= */
+
+static int order_for(size_t need) {
+    int order = BUDDY_MIN_ORDER;
+    while (order <= buddyTopOrder && ((size_t)1 << order) < need)
+        order++;
+    return order;
+}
+
+static char *buddy_alloc(size_t need) {
+    int order = order_for(need);
+    if (order > buddyTopOrder)
+        return nullptr;
+
+    int o = order;
+    while (o <= buddyTopOrder && !buddyFree[o])
+        o++;
+    if (o > buddyTopOrder)
+        return nullptr;
+
+    char *block = buddyFree[o];
+    list_unlink(buddyFree[o], block);
+
+    while (o > order) {
+        o--;
+        char *half = block + ((size_t)1 << o);
+        tag_of(half)->info = ((size_t)1 << o);
+        list_push(buddyFree[o], half);
+    }
+
+    tag_of(block)->info = ((size_t)1 << order) | USED;
+    return block;
+}
+
+static void buddy_release(char *block) {
+    size_t size = block_size(block);
+    int order = __builtin_ctzll(size);
+
+    while (order < buddyTopOrder) {
+        char *buddy = region + ((size_t)(block - region) ^ ((size_t)1 << order));
+        if (block_used(buddy) || block_size(buddy) != ((size_t)1 << order))
+            break;
+
+        list_unlink(buddyFree[order], buddy);
+        if (buddy < block)
+            block = buddy;
+        order++;
+    }
+
+    tag_of(block)->info = ((size_t)1 << order);
+    list_push(buddyFree[order], block);
+}
+
+/* ================= DISPATCH ================= */
+
+static char *alloc_block(size_t size) {
+    if (!region || size > regionSize) {
+        failureCount++;
+        return nullptr;
+    }
+
+    char *block;
+    if (STRATEGY == ArenaStrategy::BUDDY)
+        block = buddy_alloc(size + TAG_SIZE);
+    else
+        block = fit_alloc(fit_need(size));
+
+    if (!block) {
+        failureCount++;
+        return nullptr;
+    }
+
+    account_alloc(block, size);
+    return block;
+}
+
+// The block's own tag loses USED before coalescing: when it merges
+// into a free predecessor or buddy, nothing rewrites it afterwards
+static void release_block(char *block) {
+    account_free(block);
+    if (STRATEGY == ArenaStrategy::BUDDY) {
+        tag_of(block)->info &= ~USED;
+        buddy_release(block);
+    } else {
+        fit_set(block, block_size(block), 0);
+        fit_release(block);
+    }
+}
+
+// Block that owns a user pointer, looking through an alias tag
+static char *owner_of(const void *p, size_t &offset) {
+    char *q = static_cast<char *>(const_cast<void *>(p));
+    Tag *t = reinterpret_cast<Tag *>(q - TAG_SIZE);
+
+    offset = 0;
+    if (t->info & ALIAS) {
+        offset = t->info & ~FLAG_MASK;
+        q -= offset;
+    }
+    return q - TAG_SIZE;
+}
+
+/* ================= PUBLIC API ================= */
+
+bool arena_init(ArenaStrategy strategy, size_t size) {
+    arena_release();
+
+    size = round_up(size, ARENA_ALIGN);
+    if (size < FIT_MIN_BLOCK)
+        size = FIT_MIN_BLOCK;
+
+    void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (map == MAP_FAILED)
+        return false;
+
+    STRATEGY = strategy;
+    region = static_cast<char *>(map);
+    mapSize = regionSize = size;
+
+    if (strategy == ArenaStrategy::BUDDY) {
+        // largest power of two that fits; the rest stays unused
+        buddyTopOrder = 63 - __builtin_clzll(size);
+        if (buddyTopOrder > BUDDY_MAX_ORDER)
+            buddyTopOrder = BUDDY_MAX_ORDER;
+        regionSize = (size_t)1 << buddyTopOrder;
+        heapEnd = region + regionSize;
+
+        tag_of(region)->info = regionSize;
+        list_push(buddyFree[buddyTopOrder], region);
+    } else {
+        heapEnd = region + size;
+        fit_set(region, size, 0);
+        list_push(fitFree, region);
+    }
+
+    return true;
+}
+
+void arena_release() {
+    if (region)
+        munmap(region, mapSize);
+
+    region = heapEnd = fitFree = nullptr;
+    mapSize = regionSize = 0;
+    for (auto &head : buddyFree)
+        head = nullptr;
+    buddyTopOrder = 0;
+    inUse = requestedBytes = peakInUse = 0;
+    mallocCount = freeCount = failureCount = 0;
+}
+
+bool arena_contains(const void *p) {
+    const char *c = static_cast<const char *>(p);
+    return region && c > region && c < heapEnd;
+}
+
+ArenaStrategy arena_strategy() {
+    return STRATEGY;
+}
+
+void *arena_malloc(size_t size) {
+    char *block = alloc_block(size ? size : 1);
+    return block ? block + TAG_SIZE : nullptr;
+}
+
+// Over-allocates by `align` and plants an alias tag in front of the
+// aligned pointer. align must be a power of two.
+void *arena_memalign(size_t align, size_t size) {
+    if (align <= ARENA_ALIGN)
+        return arena_malloc(size);
+    if (align & (align - 1) || size > SIZE_MAX - align - TAG_SIZE)
+        return nullptr;
+
+    char *block = alloc_block(size + align + TAG_SIZE);
+    if (!block)
+        return nullptr;
+
+    // count only what the caller asked for
+    requestedBytes -= tag_of(block)->requested - size;
+    tag_of(block)->requested = size;
+
+    char *payload = block + TAG_SIZE;
+    char *aligned = reinterpret_cast<char *>(
+        round_up(reinterpret_cast<uintptr_t>(payload) + TAG_SIZE, align));
+
+    Tag *alias = reinterpret_cast<Tag *>(aligned - TAG_SIZE);
+    alias->info = (uint64_t)(aligned - payload) | ALIAS | USED;
+    alias->requested = size;
+    return aligned;
+}
+
+void arena_free(void *p) {
+    if (!p || !arena_contains(p))
+        return;
+
+    size_t offset;
+    char *block = owner_of(p, offset);
+    if (block_used(block))   // a repeated free of the same pointer is ignored
+        release_block(block);
+}
+
+size_t arena_usable_size(const void *p) {
+    if (!p || !arena_contains(p))
+        return 0;
+
+    size_t offset;
+    char *block = owner_of(p, offset);
+    size_t overhead = TAG_SIZE + offset;
+    if (STRATEGY != ArenaStrategy::BUDDY)
+        overhead += FOOTER_SIZE;
+    return block_size(block) - overhead;
+}
+
+void *arena_realloc(void *p, size_t size) {
+    if (!p)
+        return arena_malloc(size);
+    if (size == 0) {
+        arena_free(p);
+        return nullptr;
+    }
+    if (!arena_contains(p) || size > regionSize)
+        return nullptr;
+
+    size_t offset;
+    char *block = owner_of(p, offset);
+    size_t usable = arena_usable_size(p);
+
+    if (offset == 0 && (size <= usable || (STRATEGY != ArenaStrategy::BUDDY
+                                           && fit_grow_in_place(block, fit_need(size))))) {
+        requestedBytes += size - tag_of(block)->requested;
+        tag_of(block)->requested = size;
+        return p;
+    }
+
+    void *fresh = arena_malloc(size);
+    if (!fresh)
+        return nullptr;
+
+    memcpy(fresh, p, usable < size ? usable : size);
+    release_block(block);
+    return fresh;
+}
+
+ArenaStats arena_stats() {
+    ArenaStats s = {};
+    s.reserved = regionSize;
+    s.inUse = inUse;
+    s.requested = requestedBytes;
+    s.peakInUse = peakInUse;
+    s.mallocs = mallocCount;
+    s.frees = freeCount;
+    s.failures = failureCount;
+
+    auto scan = [&s](char *head) {
+        for (char *b = head; b; b = links_of(b)->next) {
+            size_t size = block_size(b);
+            s.freeBytes += size;
+            s.freeBlocks++;
+            if (size > s.largestFree)
+                s.largestFree = size;
+        }
+    };
+
+    if (STRATEGY == ArenaStrategy::BUDDY) {
+        for (int o = 0; o <= buddyTopOrder; o++)
+            scan(buddyFree[o]);
+    } else {
+        scan(fitFree);
+    }
+    return s;
+}
+
+void arena_walk(ArenaVisitor visit, void *ctx) {
+    for (char *b = region; b && b < heapEnd; b += block_size(b))
+        visit(b, block_size(b), block_used(b), tag_of(b)->requested, ctx);
+}
+
+size_t arena_rss() {
+    int fd = open("/proc/self/statm", O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    char buf[128];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0)
+        return 0;
+    buf[n] = '\0';
+
+    // "size resident shared ..." in pages
+    char *p = buf;
+    strtoull(p, &p, 10);
+    size_t resident = strtoull(p, nullptr, 10);
+    return resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+bool parse_arena_strategy(const char *name, ArenaStrategy &strategy) {
+    if (!name)
+        return false;
+    if (strcmp(name, "first") == 0)
+        strategy = ArenaStrategy::FIRST_FIT;
+    else if (strcmp(name, "best") == 0)
+        strategy = ArenaStrategy::BEST_FIT;
+    else if (strcmp(name, "buddy") == 0)
+        strategy = ArenaStrategy::BUDDY;
+    else
+        return false;
+    return true;
+}
+
+const char *arena_strategy_name(ArenaStrategy strategy) {
+    switch (strategy) {
+        case ArenaStrategy::FIRST_FIT:
+            return "first";
+        case ArenaStrategy::BEST_FIT:
+            return "best";
+        case ArenaStrategy::BUDDY:
+            return "buddy";
+    }
+    return "?";
+}
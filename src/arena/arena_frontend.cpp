@@ -0,0 +1,160 @@
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
+#include "../../include/arena.h"
+#include "../../include/fragmentation.h"
+#include "../../include/sim_log.h"
+
+using namespace std;
+
+/*
+ Id-handle front end over the real-memory arena, so the simulator
+ commands (malloc / free / realloc / dump / stats) drive it like any
+ other engine. Payloads are filled on allocation: every page a block
+ spans becomes resident, and RSS shows what the strategy really costs.
+*/
+
+/* ================= STATE ================= */
+
+static ArenaStrategy STRATEGY = ArenaStrategy::FIRST_FIT;
+static size_t ARENA_SIZE = 0;
+static bool mapped = false;
+
+static unordered_map<int, void *> idToPtr;
+static int NEXT_ID = 1;
+
+static const unsigned char FILL_BYTE = 0xA5;
+
+/* ================= SETUP ================= */
+
+void arena_frontend_init(size_t size) {
+    idToPtr.clear();
+    NEXT_ID = 1;
+    ARENA_SIZE = size;
+
+    mapped = arena_init(STRATEGY, size);
+    if (!mapped)
+        cout << "[ARENA] Cannot map " << size << " bytes\n";
+}
+
+// Switching strategy remaps the region; live blocks are dropped
+void arena_frontend_strategy(ArenaStrategy strategy) {
+    if (mapped && strategy == STRATEGY)
+        return;
+
+    STRATEGY = strategy;
+    if (ARENA_SIZE > 0) {
+        if (!idToPtr.empty())
+            cout << "[ARENA] Remapped: " << idToPtr.size() << " live blocks dropped\n";
+        arena_frontend_init(ARENA_SIZE);
+    }
+}
+
+/* ================= ALLOCATION ================= */
+
+int arena_malloc_block(size_t size, size_t align) {
+    void *p = align > 1 ? arena_memalign(align, size) : arena_malloc(size);
+    if (!p) {
+        SIM_LOG << "[ARENA] Allocation of " << size << " bytes failed\n";
+        return -1;
+    }
+
+    memset(p, FILL_BYTE, size);
+
+    int id = NEXT_ID++;
+    idToPtr[id] = p;
+    SIM_LOG << "[ARENA] Allocated block " << id << " at " << p << "\n";
+    return id;
+}
+
+void arena_free_block(int id) {
+    auto it = idToPtr.find(id);
+    if (it == idToPtr.end()) {
+        SIM_LOG << "[ARENA] Invalid block id\n";
+        return;
+    }
+
+    arena_free(it->second);
+    idToPtr.erase(it);
+    SIM_LOG << "[ARENA] Freed block " << id << "\n";
+}
+
+int arena_realloc_block(int id, size_t newSize) {
+    auto it = idToPtr.find(id);
+    if (it == idToPtr.end()) {
+        SIM_LOG << "[ARENA] Invalid block id\n";
+        return -1;
+    }
+
+    size_t oldSize = arena_usable_size(it->second);
+    void *p = arena_realloc(it->second, newSize);
+    if (!p)
+        return -1;
+
+    if (newSize > oldSize)
+        memset(static_cast<char *>(p) + oldSize, FILL_BYTE, newSize - oldSize);
+
+    SIM_LOG << "[ARENA] Block " << id << (p == it->second ? " resized in place" : " moved")
+            << "\n";
+    it->second = p;
+    return id;
+}
+
+// Real address of a live block, SIZE_MAX if unknown
+size_t arena_block_address(int id) {
+    auto it = idToPtr.find(id);
+    return it == idToPtr.end() ? SIZE_MAX : reinterpret_cast<uintptr_t>(it->second);
+}
+
+/* ================= INSPECTION ================= */
+
+static void dump_block(const void *block, size_t size, bool used, size_t requested, void *ctx) {
+    const char *base = static_cast<const char *>(ctx);
+    size_t offset = static_cast<const char *>(block) - base;
+
+    cout << "[" << offset << " - " << offset + size - 1 << "] ";
+    if (used)
+        cout << "USED (" << requested << " requested)\n";
+    else
+        cout << "FREE\n";
+}
+
+void arena_dump() {
+    if (!mapped) {
+        cout << "[ARENA] Not initialized\n";
+        return;
+    }
+
+    // offsets are relative to the first block
+    const void *first = nullptr;
+    arena_walk([](const void *b, size_t, bool, size_t, void *ctx) {
+        const void **out = static_cast<const void **>(ctx);
+        if (!*out)
+            *out = b;
+    }, &first);
+
+    cout << "\n--- Arena (" << arena_strategy_name(STRATEGY) << ") at " << first << " ---\n";
+    arena_walk(dump_block, const_cast<void *>(first));
+}
+
+FragSample arena_frag_sample() {
+    ArenaStats s = arena_stats();
+    return {s.reserved, s.inUse, s.requested, s.freeBytes, s.largestFree};
+}
+
+void arena_print_stats() {
+    ArenaStats s = arena_stats();
+    FragSample f = {s.reserved, s.inUse, s.requested, s.freeBytes, s.largestFree};
+
+    cout << "\n--- Arena Statistics (" << arena_strategy_name(STRATEGY) << ") ---\n";
+    cout << "Reserved    : " << s.reserved << " bytes\n";
+    cout << "Used Memory : " << s.inUse << " (peak " << s.peakInUse << ")\n";
+    cout << "Free Memory : " << s.freeBytes << " in " << s.freeBlocks << " blocks\n";
+    cout << "Requested   : " << s.requested << "\n";
+    cout << "External Fragmentation: " << external_fragmentation(f) * 100 << "%\n";
+    cout << "Internal Fragmentation: " << internal_fragmentation(f) * 100 << "%\n";
+    cout << "Mallocs: " << s.mallocs << "  Frees: " << s.frees
+         << "  Failures: " << s.failures << "\n";
+    cout << "Process RSS : " << arena_rss() / 1024 << " KB\n";
+}
@@ -0,0 +1,199 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+#include "../../include/arena.h"
+
+/*
+ LD_PRELOAD MALLOC SHIM
+ ----------------------
+ Replaces the C allocator of any dynamically linked program with the
+ real-memory arena:
+
+   LD_PRELOAD=./libmemsim_shim.so MEMSIM_ARENA=buddy some_program
+
+ MEMSIM_ARENA        first | best | buddy        (default first)
+ MEMSIM_ARENA_MB     address space to reserve     (default 1024)
+ MEMSIM_ARENA_STATS  if set, print counters and RSS on exit
+
+ - One mutex around every call; the arena itself is single-threaded
+ - Nothing here may allocate: no stdio streams, no std::string
+ - Pointers from outside the arena (handed out before the shim took
+   over) are ignored by free. realloc cannot know their size, so it
+   fails with ENOMEM and leaves them untouched
+*/
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static bool ready = false;
+static bool failed = false;
+
+static size_t env_size(const char *name, size_t fallback) {
+    const char *v = getenv(name);
+    if (!v || !*v)
+        return fallback;
+    size_t n = strtoull(v, nullptr, 10);
+    return n ? n : fallback;
+}
+
+static void fork_prepare() { pthread_mutex_lock(&lock); }
+static void fork_release() { pthread_mutex_unlock(&lock); }
+
+// Called with the lock held
+static bool ensure_ready() {
+    if (ready)
+        return true;
+    if (failed)
+        return false;
+
+    ArenaStrategy strategy = ArenaStrategy::FIRST_FIT;
+    const char *name = getenv("MEMSIM_ARENA");
+    if (name && !parse_arena_strategy(name, strategy)) {
+        static const char msg[] = "memsim shim: unknown MEMSIM_ARENA, using first\n";
+        ssize_t ignored = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+        (void)ignored;
+    }
+
+    size_t mb = env_size("MEMSIM_ARENA_MB", 1024);
+    if (!arena_init(strategy, mb << 20)) {
+        failed = true;
+        return false;
+    }
+
+    ready = true;
+    return true;
+}
+
+/* ================= C ALLOCATOR ================= */
+
+extern "C" {
+
+void *malloc(size_t size) {
+    pthread_mutex_lock(&lock);
+    void *p = ensure_ready() ? arena_malloc(size) : nullptr;
+    pthread_mutex_unlock(&lock);
+
+    if (!p)
+        errno = ENOMEM;
+    return p;
+}
+
+void free(void *p) {
+    if (!p)
+        return;
+    pthread_mutex_lock(&lock);
+    arena_free(p);
+    pthread_mutex_unlock(&lock);
+}
+
+void *calloc(size_t n, size_t size) {
+    if (size && n > SIZE_MAX / size) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    void *p = malloc(n * size);
+    if (p)
+        memset(p, 0, n * size);
+    return p;
+}
+
+void *realloc(void *p, size_t size) {
+    pthread_mutex_lock(&lock);
+    void *q = nullptr;
+    if (ensure_ready()) {
+        // a foreign block's size is unknown, so it cannot be copied
+        if (!p || arena_contains(p))
+            q = arena_realloc(p, size);
+    }
+    pthread_mutex_unlock(&lock);
+
+    if (!q && size)
+        errno = ENOMEM;
+    return q;
+}
+
+void *memalign(size_t align, size_t size) {
+    pthread_mutex_lock(&lock);
+    void *p = ensure_ready() ? arena_memalign(align, size) : nullptr;
+    pthread_mutex_unlock(&lock);
+
+    if (!p)
+        errno = ENOMEM;
+    return p;
+}
+
+int posix_memalign(void **out, size_t align, size_t size) {
+    if (align < sizeof(void *) || (align & (align - 1)))
+        return EINVAL;
+
+    // reports through the return value; errno is left as it was
+    int saved = errno;
+    void *p = memalign(align, size);
+    if (!p) {
+        errno = saved;
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+void *aligned_alloc(size_t align, size_t size) {
+    return memalign(align, size);
+}
+
+void *valloc(size_t size) {
+    return memalign(sysconf(_SC_PAGESIZE), size);
+}
+
+void *pvalloc(size_t size) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    return memalign(page, (size + page - 1) & ~(page - 1));
+}
+
+size_t malloc_usable_size(void *p) {
+    pthread_mutex_lock(&lock);
+    size_t n = arena_usable_size(p);
+    pthread_mutex_unlock(&lock);
+    return n;
+}
+
+}
+
+/* ================= LIFECYCLE ================= */
+
+__attribute__((constructor))
+static void shim_start() {
+    // pthread_atfork may call malloc itself, so it runs outside the lock
+    pthread_atfork(fork_prepare, fork_release, fork_release);
+}
+
+__attribute__((destructor))
+static void shim_report() {
+    if (!getenv("MEMSIM_ARENA_STATS") || !ready)
+        return;
+
+    pthread_mutex_lock(&lock);
+    ArenaStats s = arena_stats();
+    ArenaStrategy strategy = arena_strategy();
+    pthread_mutex_unlock(&lock);
+
+    char buf[512];
+    int n = snprintf(buf, sizeof(buf),
+                     "memsim shim [%s]: %llu mallocs, %llu frees, %llu failures\n"
+                     "  in use %zu bytes (%zu requested), peak %zu\n"
+                     "  free %zu bytes in %zu blocks, largest %zu\n"
+                     "  RSS %zu KB\n",
+                     arena_strategy_name(strategy),
+                     (unsigned long long)s.mallocs, (unsigned long long)s.frees,
+                     (unsigned long long)s.failures,
+                     s.inUse, s.requested, s.peakInUse,
+                     s.freeBytes, s.freeBlocks, s.largestFree,
+                     arena_rss() / 1024);
+
+    if (n > 0) {
+        ssize_t ignored = write(STDERR_FILENO, buf, n < (int)sizeof(buf) ? n : sizeof(buf) - 1);
+        (void)ignored;
+    }
+}
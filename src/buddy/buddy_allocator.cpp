@@ -3,6 +3,11 @@
 #include <cmath>
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "../../include/fragmentation.h"
+#include "../../include/sim_log.h"
+#include "../../include/snapshot.h"
 
 using namespace std;
 
@@ -15,6 +20,31 @@ static int MAX_LEVEL = 0;
 // freeBlocks[level] → list of free block base addresses
 static vector<vector<size_t>> freeBlocks;
 
+// in-band header modelled in front of every payload
+static size_t HEADER_SIZE = 0;
+
+struct BuddyAlloc {
+    size_t requested;   // bytes asked for
+    size_t blockSize;   // power-of-two block handed out
+    size_t offset;      // payload start: header rounded up to the alignment
+    size_t align;       // alignment asked for, kept across realloc moves
+};
+
+// allocated block base address → accounting record
+static unordered_map<size_t, BuddyAlloc> allocated;
+
+// id-based handles for the simulator front end
+static unordered_map<int, size_t> idToAddr;
+static int NEXT_ID = 1;
+
+static int success_count = 0;
+static int failure_count = 0;
+
+static int realloc_split = 0;
+static int realloc_merged = 0;
+static int realloc_moved = 0;
+static size_t realloc_copy_bytes = 0;
+
 /* ================= INTERNAL UTILITIES ================= */
 
 // normalize requested size to power-of-two block
@@ -44,30 +74,56 @@ static size_t buddy_address(size_t addr, int level) {
 
 /* ================= INITIALIZATION ================= */
 
+// Manages the largest power-of-two multiple of BASE_BLOCK that fits;
+// the rest of memorySize stays unused, as in the real-memory arena.
 void buddy_init(size_t memorySize) {
-    TOTAL_SIZE = memorySize;
-
     MAX_LEVEL = 0;
-    size_t temp = memorySize / BASE_BLOCK;
-    while ((1UL << MAX_LEVEL) < temp)
+    while ((BASE_BLOCK << (MAX_LEVEL + 1)) <= memorySize)
         MAX_LEVEL++;
 
     freeBlocks.clear();
-    freeBlocks.resize(MAX_LEVEL + 1);
+    TOTAL_SIZE = 0;
 
-    freeBlocks[MAX_LEVEL].push_back(0);
+    if (memorySize >= BASE_BLOCK) {
+        TOTAL_SIZE = BASE_BLOCK << MAX_LEVEL;
+        freeBlocks.resize(MAX_LEVEL + 1);
+        freeBlocks[MAX_LEVEL].push_back(0);
+    }
+
+    allocated.clear();
+    idToAddr.clear();
+    NEXT_ID = 1;
+    success_count = 0;
+    failure_count = 0;
+    realloc_split = 0;
+    realloc_merged = 0;
+    realloc_moved = 0;
+    realloc_copy_bytes = 0;
+
+    SIM_LOG << "[BUDDY INIT] Memory size = " << TOTAL_SIZE;
+    if (TOTAL_SIZE != memorySize) {
+        SIM_LOG << " (rounded down from " << memorySize << ")";
+    }
+    SIM_LOG << "\n";
+}
 
-    cout << "[BUDDY INIT] Memory size = " << memorySize << "\n";
+void buddy_set_header(size_t header) {
+    HEADER_SIZE = header;
 }
 
 /* ================= ALLOCATION ================= */
 
-size_t buddy_malloc(size_t request) {
-    size_t allocSize = normalize_size(request);
+// Blocks are aligned to their own size, so alignment is met by
+// rounding the block up to at least `align`. Callers keep the
+// success / failure counts, so a realloc move is not counted as an
+// allocation.
+static size_t allocate(size_t request, size_t align, size_t header) {
+    size_t payloadOffset = (header + align - 1) / align * align;
+    size_t allocSize = normalize_size(max(payloadOffset + request, align));
     int targetLevel = size_to_level(allocSize);
 
-    if (targetLevel > MAX_LEVEL) {
-        cout << "[BUDDY] Allocation failed (too large)\n";
+    if (freeBlocks.empty() || targetLevel > MAX_LEVEL) {
+        SIM_LOG << "[BUDDY] Allocation failed (too large)\n";
         return SIZE_MAX;
     }
 
@@ -76,7 +132,7 @@ size_t buddy_malloc(size_t request) {
         level++;
 
     if (level > MAX_LEVEL) {
-        cout << "[BUDDY] Allocation failed (no block)\n";
+        SIM_LOG << "[BUDDY] Allocation failed (no block)\n";
         return SIZE_MAX;
     }
 
@@ -89,16 +145,48 @@ size_t buddy_malloc(size_t request) {
         freeBlocks[level].push_back(splitAddr);
     }
 
-    cout << "[BUDDY] Allocated block at " << addr
-         << " (size " << allocSize << ")\n";
+    allocated[addr] = {request, allocSize, payloadOffset, align};
+
+    SIM_LOG << "[BUDDY] Allocated block at " << addr
+            << " (size " << allocSize << ")\n";
 
     return addr;
 }
 
+// raw page-style allocation (no header), used by the slab engine
+size_t buddy_malloc(size_t request, size_t align) {
+    size_t addr = allocate(request, align, 0);
+    if (addr == SIZE_MAX)
+        failure_count++;
+    else
+        success_count++;
+    return addr;
+}
+
+int buddy_malloc_block(size_t request, size_t align) {
+    size_t addr = allocate(request, align, HEADER_SIZE);
+    if (addr == SIZE_MAX) {
+        failure_count++;
+        return -1;
+    }
+
+    success_count++;
+    int id = NEXT_ID++;
+    idToAddr[id] = addr;
+    return id;
+}
+
 /* ================= DEALLOCATION ================= */
 
 void buddy_free(size_t addr, size_t originalSize) {
     size_t size = normalize_size(originalSize);
+
+    auto rec = allocated.find(addr);
+    if (rec != allocated.end()) {
+        size = rec->second.blockSize;
+        allocated.erase(rec);
+    }
+
     int level = size_to_level(size);
 
     while (level < MAX_LEVEL) {
@@ -115,14 +203,297 @@ void buddy_free(size_t addr, size_t originalSize) {
     }
 
     freeBlocks[level].push_back(addr);
-    cout << "[BUDDY] Freed block at " << addr << "\n";
+    SIM_LOG << "[BUDDY] Freed block at " << addr << "\n";
+}
+
+void buddy_free_block(int id) {
+    auto it = idToAddr.find(id);
+    if (it == idToAddr.end()) {
+        SIM_LOG << "[BUDDY] Invalid block id\n";
+        return;
+    }
+
+    size_t addr = it->second;
+    idToAddr.erase(it);
+    buddy_free(addr, allocated[addr].requested);
+}
+
+// Payload address (past the header and alignment padding) of a live
+// block, SIZE_MAX if unknown
+size_t buddy_block_address(int id) {
+    auto it = idToAddr.find(id);
+    if (it == idToAddr.end())
+        return SIZE_MAX;
+    return it->second + allocated[it->second].offset;
+}
+
+/* ================= REALLOC ================= */
+
+// Removes a specific free block from its level list if present
+static bool take_free(size_t addr, int level) {
+    auto &list = freeBlocks[level];
+    auto it = find(list.begin(), list.end(), addr);
+    if (it == list.end())
+        return false;
+    list.erase(it);
+    return true;
+}
+
+// Resizes block `id` keeping the id as the handle. Shrinking splits off
+// upper halves; growing absorbs free upper buddies when the block is
+// aligned for the larger size; otherwise allocate-copy-free with the
+// block's original alignment.
+int buddy_realloc_block(int id, size_t newSize) {
+    auto it = idToAddr.find(id);
+    if (it == idToAddr.end()) {
+        SIM_LOG << "[BUDDY] Invalid block id\n";
+        return -1;
+    }
+
+    size_t addr = it->second;
+    BuddyAlloc &rec = allocated[addr];
+    size_t newBlock = normalize_size(max(rec.offset + newSize, rec.align));
+    int level = size_to_level(rec.blockSize);
+    int target = size_to_level(newBlock);
+
+    if (target == level) {
+        rec.requested = newSize;
+        SIM_LOG << "[BUDDY] Block " << id << " resized in place\n";
+        return id;
+    }
+
+    /* ---- shrink: release upper halves ---- */
+    if (target < level) {
+        while (level > target) {
+            level--;
+            freeBlocks[level].push_back(addr + (BASE_BLOCK << level));
+        }
+
+        rec.blockSize = newBlock;
+        rec.requested = newSize;
+        realloc_split++;
+        SIM_LOG << "[BUDDY] Block " << id << " split in place to "
+                << newBlock << "\n";
+        return id;
+    }
+
+    /* ---- grow: merge with free upper buddies ---- */
+    bool mergeable = target <= MAX_LEVEL && addr % newBlock == 0;
+
+    for (int lvl = level; mergeable && lvl < target; lvl++) {
+        size_t buddy = addr + (BASE_BLOCK << lvl);
+        auto &list = freeBlocks[lvl];
+        mergeable = find(list.begin(), list.end(), buddy) != list.end();
+    }
+
+    if (mergeable) {
+        for (int lvl = level; lvl < target; lvl++)
+            take_free(addr + (BASE_BLOCK << lvl), lvl);
+
+        rec.blockSize = newBlock;
+        rec.requested = newSize;
+        realloc_merged++;
+        SIM_LOG << "[BUDDY] Block " << id << " merged in place to "
+                << newBlock << "\n";
+        return id;
+    }
+
+    /* ---- allocate, copy, free ---- */
+    size_t oldRequested = rec.requested;
+    size_t newAddr = allocate(newSize, rec.align, HEADER_SIZE);
+    if (newAddr == SIZE_MAX) {
+        SIM_LOG << "[BUDDY] Block " << id << " unchanged (no space)\n";
+        return -1;
+    }
+
+    buddy_free(addr, oldRequested);
+    idToAddr[id] = newAddr;
+    realloc_moved++;
+    realloc_copy_bytes += min(oldRequested, newSize);
+
+    SIM_LOG << "[BUDDY] Block " << id << " moved to " << newAddr
+            << ", copied " << min(oldRequested, newSize) << " units\n";
+    return id;
+}
+
+/* ================= CHECKPOINT ================= */
+
+struct BuddyCheckpoint {
+    uint64_t totalSize, baseBlock;
+    int64_t maxLevel, nextId, successCount, failureCount;
+    int64_t reallocSplit, reallocMerged, reallocMoved;
+    uint64_t reallocCopyBytes;
+};
+
+struct BuddyAllocRecord {
+    uint64_t addr, requested, blockSize, offset, align;
+};
+
+struct BuddyIdRecord {
+    int64_t id;
+    uint64_t addr;
+};
+
+// Free lists keep their order; the hash maps are written sorted so
+// equal states give byte-identical snapshots.
+void buddy_checkpoint(SnapshotWriter &w) {
+    BuddyCheckpoint c = {
+        TOTAL_SIZE, BASE_BLOCK, MAX_LEVEL, NEXT_ID, success_count,
+        failure_count, realloc_split, realloc_merged, realloc_moved,
+        realloc_copy_bytes
+    };
+
+    vector<BuddyAllocRecord> blocks;
+    for (auto &a : allocated)
+        blocks.push_back({a.first, a.second.requested, a.second.blockSize, a.second.offset,
+                          a.second.align});
+    sort(blocks.begin(), blocks.end(), [](const BuddyAllocRecord &x, const BuddyAllocRecord &y) {
+        return x.addr < y.addr;
+    });
+
+    vector<BuddyIdRecord> ids;
+    for (auto &h : idToAddr)
+        ids.push_back({h.first, h.second});
+    sort(ids.begin(), ids.end(), [](const BuddyIdRecord &x, const BuddyIdRecord &y) {
+        return x.id < y.id;
+    });
+
+    w.section(SEC_BUDDY);
+    w.put(c);
+    w.put<uint64_t>(freeBlocks.size());
+    for (auto &level : freeBlocks)
+        w.putVector(level);
+    w.putVector(blocks);
+    w.putVector(ids);
+}
+
+// Restore is staged: the section is parsed and checked into
+// `staged` first, and the engine only changes on commit.
+struct BuddyImage {
+    BuddyCheckpoint c;
+    vector<vector<size_t>> lists;
+    vector<BuddyAllocRecord> blocks;
+    vector<BuddyIdRecord> ids;
+};
+
+static BuddyImage staged;
+
+static bool power_of_two(size_t v) {
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+// Free and allocated blocks must be size-aligned and tile the managed
+// range exactly; every id must name an allocated block.
+static bool buddy_valid(const BuddyImage &img) {
+    const BuddyCheckpoint &c = img.c;
+
+    if (img.lists.empty())
+        return img.blocks.empty() && img.ids.empty();
+
+    // baseBlock << maxLevel must not overflow
+    if (!power_of_two(c.baseBlock) || c.maxLevel < 0
+        || c.maxLevel >= 64 - __builtin_ctzll(c.baseBlock)
+        || img.lists.size() != (size_t)c.maxLevel + 1 || c.nextId < 1)
+        return false;
+
+    size_t span = c.baseBlock << c.maxLevel;
+    vector<pair<size_t, size_t>> extents;
+
+    for (size_t lvl = 0; lvl < img.lists.size(); lvl++) {
+        size_t size = c.baseBlock << lvl;
+        for (size_t addr : img.lists[lvl]) {
+            if (addr % size != 0 || addr > span - size)
+                return false;
+            extents.push_back({addr, size});
+        }
+    }
+
+    for (auto &b : img.blocks) {
+        if (!power_of_two(b.blockSize) || b.blockSize < c.baseBlock
+            || b.blockSize > span || b.addr % b.blockSize != 0
+            || b.addr > span - b.blockSize || !power_of_two(b.align)
+            || b.offset > b.blockSize || b.requested > b.blockSize - b.offset)
+            return false;
+        extents.push_back({b.addr, b.blockSize});
+    }
+
+    sort(extents.begin(), extents.end());
+    size_t expected = 0;
+    for (auto &e : extents) {
+        if (e.first != expected)
+            return false;
+        expected += e.second;
+    }
+    if (expected != span)
+        return false;
+
+    vector<size_t> addrs;
+    for (auto &b : img.blocks)
+        addrs.push_back(b.addr);
+    sort(addrs.begin(), addrs.end());
+
+    // ids are written sorted, so a repeat shows up as a neighbour
+    for (size_t i = 0; i < img.ids.size(); i++) {
+        const BuddyIdRecord &h = img.ids[i];
+        if (h.id < 1 || h.id >= c.nextId || (i > 0 && img.ids[i - 1].id >= h.id)
+            || !binary_search(addrs.begin(), addrs.end(), h.addr))
+            return false;
+    }
+    return true;
+}
+
+bool buddy_restore_stage(const SnapshotReader &r) {
+    SectionCursor cur;
+    uint64_t levels = 0;
+
+    if (!r.section(SEC_BUDDY, cur) || !cur.get(staged.c) || !cur.get(levels)
+        || levels > 64)
+        return false;
+
+    staged.lists.assign(levels, {});
+    for (auto &level : staged.lists)
+        cur.getVector(level);
+    cur.getVector(staged.blocks);
+    cur.getVector(staged.ids);
+
+    return cur.ok() && buddy_valid(staged);
+}
+
+// Only after buddy_restore_stage() succeeded
+void buddy_restore_commit() {
+    const BuddyCheckpoint &c = staged.c;
+
+    freeBlocks.swap(staged.lists);
+    allocated.clear();
+    allocated.reserve(staged.blocks.size());
+    for (auto &b : staged.blocks)
+        allocated[b.addr] = {b.requested, b.blockSize, b.offset, b.align};
+    idToAddr.clear();
+    idToAddr.reserve(staged.ids.size());
+    for (auto &h : staged.ids)
+        idToAddr[h.id] = h.addr;
+
+    staged.lists.clear();
+    staged.blocks.clear();
+    staged.ids.clear();
+
+    TOTAL_SIZE = c.totalSize;
+    BASE_BLOCK = c.baseBlock;
+    MAX_LEVEL = c.maxLevel;
+    NEXT_ID = c.nextId;
+    success_count = c.successCount;
+    failure_count = c.failureCount;
+    realloc_split = c.reallocSplit;
+    realloc_merged = c.reallocMerged;
+    realloc_moved = c.reallocMoved;
+    realloc_copy_bytes = c.reallocCopyBytes;
 }
 
 /* ================= DEBUG VIEW ================= */
 
 void buddy_dump() {
     cout << "\n--- Buddy Free Lists ---\n";
-    for (int lvl = 0; lvl <= MAX_LEVEL; lvl++) {
+    for (int lvl = 0; lvl < (int)freeBlocks.size(); lvl++) {
         cout << "Level " << lvl << " (" 
              << (BASE_BLOCK << lvl) << "): ";
         for (auto addr : freeBlocks[lvl])
@@ -130,3 +501,45 @@ void buddy_dump() {
         cout << "\n";
     }
 }
+
+/* ================= STATS ================= */
+
+FragSample buddy_frag_sample() {
+    FragSample s = {TOTAL_SIZE, 0, 0, 0, 0};
+
+    for (auto &entry : allocated) {
+        s.used += entry.second.blockSize;
+        s.requested += entry.second.requested;
+    }
+
+    for (int lvl = 0; lvl < (int)freeBlocks.size(); lvl++) {
+        size_t blockSize = BASE_BLOCK << lvl;
+        s.freeBytes += blockSize * freeBlocks[lvl].size();
+        if (!freeBlocks[lvl].empty())
+            s.largestFree = max(s.largestFree, blockSize);
+    }
+
+    return s;
+}
+
+void buddy_stats() {
+    FragSample s = buddy_frag_sample();
+    size_t wasted = s.used - s.requested;
+
+    cout << "\n--- Buddy Statistics ---\n";
+    cout << "Total Memory: " << TOTAL_SIZE << "\n";
+    cout << "Used Memory : " << s.used << "\n";
+    cout << "Free Memory : " << s.freeBytes << "\n";
+    cout << "Requested   : " << s.requested << "\n";
+    cout << "External Fragmentation: "
+         << external_fragmentation(s) * 100 << "%\n";
+    cout << "Internal Fragmentation: "
+         << internal_fragmentation(s) * 100 << "% (" << wasted << " units)\n";
+    cout << "  Header Overhead : " << HEADER_SIZE * idToAddr.size() << "\n";
+    cout << "Alloc Success: " << success_count << "\n";
+    cout << "Alloc Failure: " << failure_count << "\n";
+    cout << "Realloc Split  : " << realloc_split << "\n";
+    cout << "Realloc Merged : " << realloc_merged << "\n";
+    cout << "Realloc Moved  : " << realloc_moved
+         << " (" << realloc_copy_bytes << " units copied)\n";
+}
@@ -1,7 +1,7 @@
 #include <iostream>
-#include <vector>
-#include <cmath>
-#include <cstddef>
+#include <iomanip>
+#include <string>
+#include "../../include/cache.h"
 
 using namespace std;
 
@@ -13,150 +13,41 @@ using namespace std;
  - LRU in L1, FIFO in L2
  - Symbolic access timing
  - Modified access trace for originality
+ - Noisy-neighbour run: a hot working set next to a streaming scan,
+   shared vs. way-partitioned, plus victim cache and sectored L1
 */
 
-// ---------- Replacement Policy ----------
-enum class ReplacePolicy {
-    FIFO,
-    LRU
-};
-
-// ---------- Cache Line ----------
-struct Line {
-    bool valid;
-    size_t tag;
-    size_t stamp;
-
-    Line() : valid(false), tag(0), stamp(0) {}
-};
-
-// ---------- Cache Level ----------
-class Cache {
-public:
-    size_t cacheSize;
-    size_t blockSize;
-    size_t ways;
-    size_t setsCount;
-
-    vector<vector<Line>> sets;
-    ReplacePolicy policy;
-
-    size_t hits;
-    size_t misses;
-    size_t clock;
-    size_t latency;
-
-    Cache(size_t c, size_t b, size_t w,
-          ReplacePolicy p, size_t delay)
-        : cacheSize(c), blockSize(b), ways(w),
-          policy(p), hits(0), misses(0),
-          clock(0), latency(delay) {
-
-        setsCount = (cacheSize / blockSize) / ways;
-        sets.resize(setsCount, vector<Line>(ways));
-    }
+// ---------- Noisy Neighbour ----------
+static const size_t HOT_SET = 24 * 1024;        // fits in L2
+static const size_t SCAN_SIZE = 1024 * 1024;    // does not
+static const size_t ROUNDS = 200000;
 
-    bool access(size_t addr) {
-        clock++;
-
-        size_t offsetBits = log2(blockSize);
-        size_t indexBits  = log2(setsCount);
-
-        size_t index = (addr >> offsetBits) & ((1 << indexBits) - 1);
-        size_t tag   = addr >> (offsetBits + indexBits);
-
-        auto &set = sets[index];
-
-        // HIT
-        for (auto &line : set) {
-            if (line.valid && line.tag == tag) {
-                hits++;
-                if (policy == ReplacePolicy::LRU)
-                    line.stamp = clock;
-                return true;
-            }
-        }
-
-        // MISS
-        misses++;
-
-        for (auto &line : set) {
-            if (!line.valid) {
-                line.valid = true;
-                line.tag = tag;
-                line.stamp = clock;
-                return false;
-            }
-        }
-
-        // Replacement
-        size_t victim = 0;
-        size_t minStamp = set[0].stamp;
-
-        for (size_t i = 1; i < set.size(); i++) {
-            if (set[i].stamp < minStamp) {
-                minStamp = set[i].stamp;
-                victim = i;
-            }
-        }
-
-        set[victim].tag = tag;
-        set[victim].stamp = clock;
-        return false;
-    }
+static CacheHierarchy make_hierarchy() {
+    return CacheHierarchy(Cache(4 * 1024, 64, 4, ReplacePolicy::LRU, 1),
+                          Cache(32 * 1024, 64, 8, ReplacePolicy::LRU, 8));
+}
 
-    double hitRate() const {
-        size_t total = hits + misses;
-        return total ? (double)hits / total : 0.0;
-    }
-};
-
-// ---------- Cache System ----------
-class CacheHierarchy {
-public:
-    Cache L1;
-    Cache L2;
-    size_t totalTime;
-
-    CacheHierarchy()
-        : L1(256, 32, 4, ReplacePolicy::LRU, 1),
-          L2(1024, 64, 4, ReplacePolicy::FIFO, 8),
-          totalTime(0) {}
-
-    void access(size_t addr) {
-        totalTime += L1.latency;
-        if (L1.access(addr)) {
-            cout << "L1 HIT\n";
-            return;
-        }
-
-        totalTime += L2.latency;
-        if (L2.access(addr)) {
-            cout << "L2 HIT -> promoted to L1\n";
-            L1.access(addr);
-            return;
-        }
-
-        cout << "CACHE MISS -> Main Memory\n";
-        totalTime += 80;
-
-        L2.access(addr);
-        L1.access(addr);
-    }
+// COS 0: random reads in the hot set; COS 1: sequential scan
+static void run_neighbours(const string &label, CacheHierarchy &c) {
+    size_t seed = 12345, scan = 0;
 
-    void stats() {
-        cout << "\n--- Cache Performance ---\n";
-        cout << "L1 Hits: " << L1.hits << "\n";
-        cout << "L1 Misses: " << L1.misses << "\n";
-        cout << "L1 Hit Rate: " << L1.hitRate() * 100 << "%\n\n";
+    for (size_t i = 0; i < ROUNDS; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        c.access(1 << 24 | (seed >> 33) % HOT_SET, 0);
+        c.access(2 << 24 | scan, 1);
+        scan = (scan + 64) % SCAN_SIZE;
+    }
 
-        cout << "L2 Hits: " << L2.hits << "\n";
-        cout << "L2 Misses: " << L2.misses << "\n";
-        cout << "L2 Hit Rate: " << L2.hitRate() * 100 << "%\n\n";
+    const PartitionStats &hot = c.L2.partitions[0];
+    const PartitionStats &noisy = c.L2.partitions[1];
 
-        cout << "Total Access Time: " << totalTime << " cycles\n";
-    }
-};
+    cout << left << setw(26) << label << right << fixed << setprecision(2)
+         << setw(9) << c.L1.hitRate() * 100
+         << setw(10) << 100.0 * hot.hits / (hot.hits + hot.misses)
+         << setw(10) << 100.0 * noisy.hits / (noisy.hits + noisy.misses)
+         << setw(9) << hot.lost
+         << setw(12) << c.totalTime << "\n";
+}
 
 // ---------- Driver ----------
 int main() {
@@ -176,5 +67,34 @@ int main() {
     }
 
     cache.stats();
+
+    cout << "\n=== NOISY NEIGHBOUR (L1 4KB, L2 32KB 8-way) ===\n";
+    cout << left << setw(26) << "config" << right << setw(9) << "L1%"
+         << setw(10) << "hot L2%" << setw(10) << "scan L2%"
+         << setw(9) << "hot lost" << setw(12) << "cycles" << "\n";
+
+    SIM_VERBOSE = false;
+
+    CacheHierarchy shared = make_hierarchy();
+    run_neighbours("shared", shared);
+
+    // CAT sweep: the scan gets the low ways, the hot set the rest
+    for (size_t scanWays = 1; scanWays < 8; scanWays *= 2) {
+        CacheHierarchy part = make_hierarchy();
+        part.L2.setWayMask(1, (1ULL << scanWays) - 1);
+        part.L2.setWayMask(0, 0xFF & ~((1ULL << scanWays) - 1));
+        run_neighbours("CAT scan " + to_string(scanWays) + "/8 ways", part);
+    }
+
+    CacheHierarchy withVictim = make_hierarchy();
+    withVictim.attachVictim(16, 2);
+    run_neighbours("shared + 16-entry victim", withVictim);
+
+    CacheHierarchy sectored = make_hierarchy();
+    sectored.L1.setSectorSize(16);
+    run_neighbours("shared + L1 16B sectors", sectored);
+
+    withVictim.stats();
+    sectored.L1.detailStats("L1");
     return 0;
 }
@@ -0,0 +1,191 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include "../../include/thread_cache.h"
+
+using namespace std;
+
+/*
+ THREAD-CACHING ALLOCATOR STRESS BENCHMARK
+ -----------------------------------------
+ - Runs the allocator with 1, 2, 4, ... N real OS threads
+ - Each thread keeps a sliding window of live objects
+ - Every HANDOFF_EVERY-th allocation is swapped through a shared
+   mailbox, so another thread ends up freeing it
+ - Reports ops/sec and speedup relative to one thread
+*/
+
+static const size_t MEMORY_SIZE = 256UL * 1024 * 1024;
+static const size_t WINDOW = 256;         // live objects per thread
+static const size_t MAILBOX_SLOTS = 1024;
+static const size_t HANDOFF_EVERY = 8;
+static const size_t EMPTY_SLOT = SIZE_MAX;
+static const int TID_SHIFT = 48;          // mailbox entries carry the owner id
+
+static atomic<size_t> mailbox[MAILBOX_SLOTS];
+static atomic<bool> start_flag(false);
+static atomic<uint64_t> cross_frees(0);
+
+struct WorkerResult {
+    uint64_t ops;
+};
+
+static inline uint64_t xorshift(uint64_t &s) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s;
+}
+
+static void worker(size_t tid, size_t opsTarget, WorkerResult &result) {
+    uint64_t rng = 0x9E3779B97F4A7C15ULL * (tid + 1);
+    vector<size_t> window(WINDOW, EMPTY_SLOT);
+    size_t cursor = 0;
+    uint64_t ops = 0;
+    uint64_t remote = 0;
+
+    while (!start_flag.load(memory_order_acquire))
+        this_thread::yield();
+
+    while (ops < opsTarget) {
+        uint64_t r = xorshift(rng);
+        size_t size = 1 + (r & 2047);
+
+        size_t addr = tc_malloc(size);
+        ops++;
+        if (addr == SIZE_MAX)
+            continue;
+
+        if ((r >> 16) % HANDOFF_EVERY == 0) {
+            size_t slot = (r >> 24) % MAILBOX_SLOTS;
+            size_t tagged = ((size_t)tid << TID_SHIFT) | addr;
+            size_t old = mailbox[slot].exchange(tagged, memory_order_acq_rel);
+
+            if (old != EMPTY_SLOT) {
+                if ((old >> TID_SHIFT) != tid)
+                    remote++;
+                tc_free(old & ((1ULL << TID_SHIFT) - 1));
+                ops++;
+            }
+            continue;
+        }
+
+        size_t &slot = window[cursor];
+        cursor = (cursor + 1) % WINDOW;
+
+        if (slot != EMPTY_SLOT) {
+            tc_free(slot);
+            ops++;
+        }
+        slot = addr;
+    }
+
+    for (size_t addr : window) {
+        if (addr != EMPTY_SLOT)
+            tc_free(addr);
+    }
+
+    cross_frees += remote;
+    result.ops = ops;
+}
+
+static double run_round(size_t threads, size_t opsPerThread, TcCounters &counters) {
+    tc_init(MEMORY_SIZE);
+    for (auto &slot : mailbox)
+        slot.store(EMPTY_SLOT);
+    start_flag = false;
+    cross_frees = 0;
+
+    vector<WorkerResult> results(threads);
+    vector<thread> pool;
+
+    for (size_t t = 0; t < threads; t++)
+        pool.emplace_back(worker, t, opsPerThread, ref(results[t]));
+
+    auto begin = chrono::steady_clock::now();
+    start_flag.store(true, memory_order_release);
+
+    for (auto &th : pool)
+        th.join();
+
+    auto end = chrono::steady_clock::now();
+
+    for (auto &slot : mailbox) {
+        size_t old = slot.exchange(EMPTY_SLOT);
+        if (old != EMPTY_SLOT)
+            tc_free(old & ((1ULL << TID_SHIFT) - 1));
+    }
+    tc_thread_flush();
+
+    uint64_t ops = 0;
+    for (auto &r : results)
+        ops += r.ops;
+
+    counters = tc_counters();
+    double seconds = chrono::duration<double>(end - begin).count();
+    return seconds > 0 ? ops / seconds : 0.0;
+}
+
+// Usage: memsim_stress [max_threads] [ops_per_thread]
+int main(int argc, char **argv) {
+    size_t maxThreads = thread::hardware_concurrency();
+    size_t opsPerThread = 2000000;
+
+    if (argc > 1)
+        maxThreads = strtoul(argv[1], nullptr, 10);
+    if (argc > 2)
+        opsPerThread = strtoul(argv[2], nullptr, 10);
+    if (maxThreads == 0)
+        maxThreads = 1;
+
+    vector<size_t> counts;
+    for (size_t t = 1; t < maxThreads; t <<= 1)
+        counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    cout << "=== THREAD-CACHING ALLOCATOR STRESS TEST ===\n\n";
+
+    struct Row {
+        size_t threads;
+        double opsPerSec;
+        TcCounters counters;
+        uint64_t remote;
+    };
+    vector<Row> rows;
+
+    for (size_t t : counts) {
+        TcCounters counters;
+        double rate = run_round(t, opsPerThread, counters);
+        rows.push_back({t, rate, counters, cross_frees.load()});
+    }
+
+    double base = rows.empty() ? 0.0 : rows[0].opsPerSec;
+
+    cout << "\n" << left
+         << setw(9) << "Threads"
+         << setw(15) << "Mops/sec"
+         << setw(10) << "Speedup"
+         << setw(12) << "Refills"
+         << setw(12) << "Flushes"
+         << setw(13) << "CAS Retries"
+         << setw(14) << "Remote Frees"
+         << "Failures\n";
+
+    for (auto &r : rows) {
+        cout << setw(9) << r.threads
+             << setw(15) << fixed << setprecision(2) << r.opsPerSec / 1e6
+             << setw(10) << (base > 0 ? r.opsPerSec / base : 0.0)
+             << setw(12) << r.counters.refills
+             << setw(12) << r.counters.flushes
+             << setw(13) << r.counters.casRetries
+             << setw(14) << r.remote
+             << r.counters.failures << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,300 @@
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "../../include/thread_cache.h"
+
+using namespace std;
+
+/*
+ THREAD-CACHING ALLOCATOR
+ ------------------------
+ - Fixed size classes, one contiguous region per class
+ - Per-thread magazines in front of a shared central pool
+ - Central free lists are lock-free Treiber stacks; the head packs
+   a 32-bit ABA tag with a 32-bit object index
+ - Refill and flush move objects in batches with a single CAS
+ - Frees may come from any thread (cross-thread frees land in the
+   freeing thread's magazine)
+*/
+
+/* ================= CONFIGURATION ================= */
+
+static const int TC_CLASSES = 8;
+static const size_t TC_CLASS_SIZES[TC_CLASSES] = {
+    16, 32, 64, 128, 256, 512, 1024, 2048
+};
+
+static const size_t MAGAZINE_SIZE = 64;   // cached objects per class per thread
+static const size_t BATCH_SIZE = 32;      // objects moved per refill / flush
+static const uint32_t NIL = UINT32_MAX;
+
+/* ================= CENTRAL POOL ================= */
+
+struct alignas(64) CentralList {
+    atomic<uint64_t> head;                 // (tag << 32) | index
+    size_t objSize;
+    size_t base;                           // address of object 0
+    uint32_t count;                        // objects in this class
+    unique_ptr<atomic<uint32_t>[]> next;   // free list links by index
+};
+
+static CentralList central[TC_CLASSES];
+static atomic<uint32_t> generation(0);
+
+static atomic<uint64_t> total_allocs(0);
+static atomic<uint64_t> total_frees(0);
+static atomic<uint64_t> total_failures(0);
+static atomic<uint64_t> total_refills(0);
+static atomic<uint64_t> total_flushes(0);
+static atomic<uint64_t> total_retries(0);
+
+static inline uint64_t pack_head(uint64_t oldHead, uint32_t index) {
+    uint64_t tag = (oldHead >> 32) + 1;
+    return (tag << 32) | index;
+}
+
+// Detach up to `want` objects from the central list in one CAS.
+// A concurrent push or pop bumps the tag, so a chain read from a
+// stale head is simply discarded by the failing CAS.
+static size_t central_pop_batch(CentralList &c, uint32_t *out,
+                                size_t want, uint64_t &retries) {
+    uint64_t head = c.head.load(memory_order_acquire);
+
+    while (true) {
+        uint32_t cur = (uint32_t)head;
+        if (cur == NIL)
+            return 0;
+
+        size_t n = 0;
+        while (n < want && cur != NIL) {
+            out[n++] = cur;
+            cur = c.next[cur].load(memory_order_relaxed);
+        }
+
+        if (c.head.compare_exchange_weak(head, pack_head(head, cur),
+                                         memory_order_acq_rel,
+                                         memory_order_acquire))
+            return n;
+
+        retries++;
+    }
+}
+
+// Link the objects into a chain and splice it on top in one CAS
+static void central_push_batch(CentralList &c, const uint32_t *items,
+                               size_t n, uint64_t &retries) {
+    for (size_t i = 0; i + 1 < n; i++)
+        c.next[items[i]].store(items[i + 1], memory_order_relaxed);
+
+    uint64_t head = c.head.load(memory_order_relaxed);
+
+    while (true) {
+        c.next[items[n - 1]].store((uint32_t)head, memory_order_relaxed);
+
+        if (c.head.compare_exchange_weak(head, pack_head(head, items[0]),
+                                         memory_order_release,
+                                         memory_order_relaxed))
+            return;
+
+        retries++;
+    }
+}
+
+/* ================= THREAD CACHE ================= */
+
+struct Magazine {
+    uint32_t items[MAGAZINE_SIZE];
+    size_t count;
+};
+
+struct ThreadCache {
+    Magazine mags[TC_CLASSES];
+    uint32_t gen;
+    uint64_t allocs, frees, failures, refills, flushes, retries;
+
+    ThreadCache() : gen(UINT32_MAX) { reset(); }
+
+    void reset() {
+        for (auto &m : mags)
+            m.count = 0;
+        allocs = frees = failures = refills = flushes = retries = 0;
+    }
+
+    void publish() {
+        total_allocs += allocs;
+        total_frees += frees;
+        total_failures += failures;
+        total_refills += refills;
+        total_flushes += flushes;
+        total_retries += retries;
+        allocs = frees = failures = refills = flushes = retries = 0;
+    }
+
+    void flush() {
+        if (gen == generation.load(memory_order_relaxed)) {
+            for (int cls = 0; cls < TC_CLASSES; cls++) {
+                Magazine &m = mags[cls];
+                if (m.count > 0) {
+                    central_push_batch(central[cls], m.items, m.count, retries);
+                    m.count = 0;
+                    flushes++;
+                }
+            }
+            publish();
+        }
+        reset();
+    }
+
+    ~ThreadCache() { flush(); }
+};
+
+static thread_local ThreadCache tcache;
+
+// magazines from a previous tc_init() refer to a pool that no longer exists
+static inline ThreadCache &local_cache() {
+    uint32_t gen = generation.load(memory_order_relaxed);
+    if (tcache.gen != gen) {
+        tcache.reset();
+        tcache.gen = gen;
+    }
+    return tcache;
+}
+
+static inline int class_for(size_t size) {
+    for (int i = 0; i < TC_CLASSES; i++) {
+        if (TC_CLASS_SIZES[i] >= size)
+            return i;
+    }
+    return -1;
+}
+
+static inline int class_of_addr(size_t addr) {
+    for (int i = 0; i < TC_CLASSES; i++) {
+        const CentralList &c = central[i];
+        if (addr >= c.base && addr < c.base + c.count * c.objSize)
+            return i;
+    }
+    return -1;
+}
+
+/* ================= PUBLIC API ================= */
+
+void tc_init(size_t memorySize) {
+    size_t region = memorySize / TC_CLASSES;
+    size_t base = 0;
+
+    for (int i = 0; i < TC_CLASSES; i++) {
+        CentralList &c = central[i];
+        size_t count = region / TC_CLASS_SIZES[i];
+        if (count >= NIL)
+            count = NIL - 1;
+
+        c.objSize = TC_CLASS_SIZES[i];
+        c.base = base;
+        c.count = count;
+        c.next.reset(new atomic<uint32_t>[count ? count : 1]);
+
+        for (uint32_t k = 0; k < count; k++)
+            c.next[k].store(k + 1 < count ? k + 1 : NIL, memory_order_relaxed);
+
+        c.head.store(count ? 0 : NIL, memory_order_relaxed);
+        base += region;
+    }
+
+    total_allocs = total_frees = total_failures = 0;
+    total_refills = total_flushes = total_retries = 0;
+    generation.fetch_add(1, memory_order_release);
+
+    cout << "[TCACHE INIT] Memory size = " << memorySize
+         << " (" << TC_CLASSES << " classes, magazine " << MAGAZINE_SIZE
+         << ", batch " << BATCH_SIZE << ")\n";
+}
+
+size_t tc_malloc(size_t size) {
+    ThreadCache &tc = local_cache();
+
+    int cls = class_for(size);
+    if (cls == -1) {
+        tc.failures++;
+        return SIZE_MAX;
+    }
+
+    Magazine &m = tc.mags[cls];
+    if (m.count == 0) {
+        m.count = central_pop_batch(central[cls], m.items, BATCH_SIZE, tc.retries);
+        if (m.count == 0) {
+            tc.failures++;
+            return SIZE_MAX;
+        }
+        tc.refills++;
+    }
+
+    tc.allocs++;
+    const CentralList &c = central[cls];
+    return c.base + (size_t)m.items[--m.count] * c.objSize;
+}
+
+void tc_free(size_t addr) {
+    ThreadCache &tc = local_cache();
+
+    int cls = class_of_addr(addr);
+    if (cls == -1)
+        return;
+
+    CentralList &c = central[cls];
+    Magazine &m = tc.mags[cls];
+
+    if (m.count == MAGAZINE_SIZE) {
+        m.count -= BATCH_SIZE;
+        central_push_batch(c, m.items + m.count, BATCH_SIZE, tc.retries);
+        tc.flushes++;
+    }
+
+    m.items[m.count++] = (uint32_t)((addr - c.base) / c.objSize);
+    tc.frees++;
+}
+
+void tc_thread_flush() {
+    local_cache().flush();
+}
+
+TcCounters tc_counters() {
+    TcCounters out;
+    out.allocs = total_allocs.load();
+    out.frees = total_frees.load();
+    out.failures = total_failures.load();
+    out.refills = total_refills.load();
+    out.flushes = total_flushes.load();
+    out.casRetries = total_retries.load();
+    return out;
+}
+
+/* ================= STATS ================= */
+
+// Walks the central lists: only meaningful while no thread is allocating
+void tc_stats() {
+    TcCounters t = tc_counters();
+
+    cout << "\n--- Thread Cache Statistics ---\n";
+    for (int i = 0; i < TC_CLASSES; i++) {
+        const CentralList &c = central[i];
+        size_t freeCount = 0;
+        uint32_t cur = (uint32_t)c.head.load();
+        while (cur != NIL && freeCount <= c.count) {
+            freeCount++;
+            cur = c.next[cur].load();
+        }
+
+        cout << "Class " << c.objSize << " | objects " << c.count
+             << " | central free " << freeCount << "\n";
+    }
+
+    cout << "Allocs      : " << t.allocs << "\n";
+    cout << "Frees       : " << t.frees << "\n";
+    cout << "Failures    : " << t.failures << "\n";
+    cout << "Refills     : " << t.refills << "\n";
+    cout << "Flushes     : " << t.flushes << "\n";
+    cout << "CAS Retries : " << t.casRetries << "\n";
+}
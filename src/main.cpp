@@ -2,27 +2,107 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#include <fstream>
+#include "../include/fragmentation.h"
+#include "../include/sim_log.h"
+#include "../include/workload.h"
+#include "../include/metrics.h"
+#include "../include/snapshot.h"
+#include "../include/arena.h"
 
 using namespace std;
 
 /* -------- Allocator APIs (implemented elsewhere) -------- */
 
 void init_memory(size_t size);
+void set_block_overhead(size_t header, size_t minBlock);
 
-int first_fit_malloc(size_t size);
-int best_fit_malloc(size_t size);
-int worst_fit_malloc(size_t size);
+int first_fit_malloc(size_t size, size_t align);
+int best_fit_malloc(size_t size, size_t align);
+int worst_fit_malloc(size_t size, size_t align);
 
 void free_block(int id);
+size_t fit_block_address(int id);
+int realloc_block(int id, size_t newSize, int (*fallback)(size_t, size_t));
 void dump_memory();
 void print_stats();
+FragSample fit_frag_sample();
+void fit_checkpoint(SnapshotWriter &w);
+bool fit_restore_stage(const SnapshotReader &r);
+void fit_restore_commit();
+
+void compact_full();
+void compact_step(size_t budget);
+void compact_cheapest(size_t target);
+bool set_auto_compaction(const string &policy, size_t budget);
+
+void buddy_init(size_t memorySize);
+void buddy_set_header(size_t header);
+int buddy_malloc_block(size_t size, size_t align);
+void buddy_free_block(int id);
+size_t buddy_block_address(int id);
+int buddy_realloc_block(int id, size_t newSize);
+void buddy_dump();
+void buddy_stats();
+FragSample buddy_frag_sample();
+void buddy_checkpoint(SnapshotWriter &w);
+bool buddy_restore_stage(const SnapshotReader &r);
+void buddy_restore_commit();
+
+void tlsf_init(size_t memorySize);
+void tlsf_set_header(size_t header);
+int tlsf_malloc(size_t size, size_t align);
+void tlsf_free(int id);
+size_t tlsf_block_address(int id);
+int tlsf_realloc(int id, size_t newSize);
+void tlsf_dump();
+void tlsf_stats();
+FragSample tlsf_frag_sample();
+void tlsf_checkpoint(SnapshotWriter &w);
+bool tlsf_restore_stage(const SnapshotReader &r);
+void tlsf_restore_commit();
+
+void slab_init();
+bool slab_configure(size_t slabSize, const vector<size_t> &sizes);
+int slab_malloc(size_t size, size_t align);
+void slab_free(int id);
+size_t slab_block_address(int id);
+int slab_realloc(int id, size_t newSize);
+void slab_dump();
+void slab_stats();
+FragSample slab_frag_sample();
+void slab_checkpoint(SnapshotWriter &w);
+bool slab_restore_stage(const SnapshotReader &r);
+void slab_restore_commit();
+
+void arena_frontend_init(size_t size);
+void arena_frontend_strategy(ArenaStrategy strategy);
+int arena_malloc_block(size_t size, size_t align);
+void arena_free_block(int id);
+size_t arena_block_address(int id);
+int arena_realloc_block(int id, size_t newSize);
+void arena_dump();
+void arena_print_stats();
+FragSample arena_frag_sample();
 
 /* -------- Allocation mode abstraction -------- */
 
 enum class AllocatorMode {
     FIRST,
     BEST,
-    WORST
+    WORST,
+    BUDDY,
+    SLAB,
+    TLSF,
+    ARENA
+};
+
+/* -------- Fragmentation time series -------- */
+
+struct FragEvent {
+    size_t event;      // operation number since init
+    string op;         // "malloc" or "free"
+    FragSample sample;
 };
 
 /* -------- Controller class (NEW STRUCTURE) -------- */
@@ -30,37 +110,291 @@ enum class AllocatorMode {
 class SimulatorController {
 private:
     AllocatorMode mode;
+    size_t headerSize;
+    size_t minBlock;
+
+    vector<FragEvent> history;
+    size_t eventCount;
 
 public:
     SimulatorController() {
         mode = AllocatorMode::FIRST;
+        headerSize = 0;
+        minBlock = 1;
+        eventCount = 0;
     }
 
     void showBanner() {
         cout << "\n===== Memory Management Simulator =====\n";
         cout << "Available commands:\n";
         cout << "  init memory <size>\n";
-        cout << "  set allocator <first|best|worst>\n";
-        cout << "  malloc <size>\n";
+        cout << "  set allocator <first|best|worst|buddy|slab|tlsf>\n";
+        cout << "  set allocator arena <first|best|buddy>\n";
+        cout << "  set slab size <bytes>\n";
+        cout << "  set slab classes <size> [size ...]\n";
+        cout << "  set header <bytes>\n";
+        cout << "  set minblock <bytes>\n";
+        cout << "  set compaction <off|full|incremental|cheapest> [budget]\n";
+        cout << "  malloc <size> [align <n>]\n";
+        cout << "  realloc <id> <size>\n";
         cout << "  free <id>\n";
+        cout << "  compact <full|step [budget]|cheapest <size>>\n";
         cout << "  dump\n";
         cout << "  stats\n";
+        cout << "  frag\n";
+        cout << "  run <trace file>\n";
+        cout << "  workload <powerlaw|bimodal|phased> <events> [seed] [max size]\n";
+        cout << "  metrics <on|off|show|reset>\n";
+        cout << "  metrics interval <events>\n";
+        cout << "  metrics export <json|csv|prom> <file>\n";
+        cout << "  checkpoint <save|load> <file>\n";
+        cout << "  whatif <checkpoint> <trace> [trace ...]\n";
         cout << "  exit\n\n";
     }
 
-    int allocateMemory(size_t size) {
+    // Engine trace output is held back while the clock runs, so a
+    // latency sample measures the engine and not the terminal
+    template <typename Call>
+    int timedCall(Call call) {
+        bool hold = METRICS_ENABLED && SIM_VERBOSE;
+        ostringstream held;
+        streambuf *out = hold ? cout.rdbuf(held.rdbuf()) : nullptr;
+
+        uint64_t start = metrics_clock();
+        int result = call();
+        metric_latency(H_ALLOC_LATENCY, start);
+
+        if (hold) {
+            cout.rdbuf(out);
+            cout << held.str();
+        }
+        return result;
+    }
+
+    int allocateMemory(size_t size, size_t align) {
+        int id = timedCall([&] { return allocateWith(size, align); });
+
+        metric_record(H_ALLOC_SIZE, size);
+        metric_count(id == -1 ? M_ALLOC_FAILS : M_ALLOCS);
+        metrics_tick();
+        return id;
+    }
+
+    int allocateWith(size_t size, size_t align) {
         switch (mode) {
             case AllocatorMode::FIRST:
-                return first_fit_malloc(size);
+                return first_fit_malloc(size, align);
             case AllocatorMode::BEST:
-                return best_fit_malloc(size);
+                return best_fit_malloc(size, align);
             case AllocatorMode::WORST:
-                return worst_fit_malloc(size);
+                return worst_fit_malloc(size, align);
+            case AllocatorMode::BUDDY:
+                return buddy_malloc_block(size, align);
+            case AllocatorMode::SLAB:
+                return slab_malloc(size, align);
+            case AllocatorMode::TLSF:
+                return tlsf_malloc(size, align);
+            case AllocatorMode::ARENA:
+                return arena_malloc_block(size, align);
         }
         return -1;
     }
 
-    void setAllocator(const string& type) {
+    // SIZE_MAX when `id` is not a live block of the current engine
+    size_t blockAddress(int id) {
+        switch (mode) {
+            case AllocatorMode::BUDDY:
+                return buddy_block_address(id);
+            case AllocatorMode::SLAB:
+                return slab_block_address(id);
+            case AllocatorMode::TLSF:
+                return tlsf_block_address(id);
+            case AllocatorMode::ARENA:
+                return arena_block_address(id);
+            default:
+                return fit_block_address(id);
+        }
+    }
+
+    // Invalid ids are reported by the engine and not counted
+    void freeMemory(int id) {
+        if (blockAddress(id) != SIZE_MAX)
+            metric_count(M_FREES);
+        metrics_tick();
+
+        switch (mode) {
+            case AllocatorMode::BUDDY:
+                buddy_free_block(id);
+                break;
+            case AllocatorMode::SLAB:
+                slab_free(id);
+                break;
+            case AllocatorMode::TLSF:
+                tlsf_free(id);
+                break;
+            case AllocatorMode::ARENA:
+                arena_free_block(id);
+                break;
+            default:
+                free_block(id);
+        }
+    }
+
+    // Timed like a malloc: a realloc is one allocator call
+    int reallocMemory(int id, size_t size) {
+        return timedCall([&] { return reallocWith(id, size); });
+    }
+
+    int reallocWith(int id, size_t size) {
+        switch (mode) {
+            case AllocatorMode::FIRST:
+                return realloc_block(id, size, first_fit_malloc);
+            case AllocatorMode::BEST:
+                return realloc_block(id, size, best_fit_malloc);
+            case AllocatorMode::WORST:
+                return realloc_block(id, size, worst_fit_malloc);
+            case AllocatorMode::BUDDY:
+                return buddy_realloc_block(id, size);
+            case AllocatorMode::SLAB:
+                return slab_realloc(id, size);
+            case AllocatorMode::TLSF:
+                return tlsf_realloc(id, size);
+            case AllocatorMode::ARENA:
+                return arena_realloc_block(id, size);
+        }
+        return -1;
+    }
+
+    bool isFitMode() const {
+        return mode == AllocatorMode::FIRST || mode == AllocatorMode::BEST
+            || mode == AllocatorMode::WORST;
+    }
+
+    void compactMemory(stringstream& parser) {
+        string kind;
+        size_t arg = 0;
+        parser >> kind >> arg;
+
+        if (!isFitMode()) {
+            cout << "[ERROR] Compaction needs a fit allocator (first|best|worst)\n";
+        }
+        else if (kind == "full") {
+            compact_full();
+            recordEvent("compact");
+        }
+        else if (kind == "step") {
+            compact_step(arg);
+            recordEvent("compact");
+        }
+        else if (kind == "cheapest" && arg > 0) {
+            compact_cheapest(arg);
+            recordEvent("compact");
+        }
+        else {
+            cout << "Usage: compact <full|step [budget]|cheapest <size>>\n";
+        }
+    }
+
+    void dumpMemory() {
+        switch (mode) {
+            case AllocatorMode::BUDDY:
+                buddy_dump();
+                break;
+            case AllocatorMode::SLAB:
+                slab_dump();
+                break;
+            case AllocatorMode::TLSF:
+                tlsf_dump();
+                break;
+            case AllocatorMode::ARENA:
+                arena_dump();
+                break;
+            default:
+                dump_memory();
+        }
+    }
+
+    void printStats() {
+        switch (mode) {
+            case AllocatorMode::BUDDY:
+                buddy_stats();
+                break;
+            case AllocatorMode::SLAB:
+                slab_stats();
+                break;
+            case AllocatorMode::TLSF:
+                tlsf_stats();
+                break;
+            case AllocatorMode::ARENA:
+                arena_print_stats();
+                break;
+            default:
+                print_stats();
+        }
+    }
+
+    FragSample sampleFragmentation() {
+        switch (mode) {
+            case AllocatorMode::BUDDY:
+                return buddy_frag_sample();
+            case AllocatorMode::SLAB:
+                return slab_frag_sample();
+            case AllocatorMode::TLSF:
+                return tlsf_frag_sample();
+            case AllocatorMode::ARENA:
+                return arena_frag_sample();
+            default:
+                return fit_frag_sample();
+        }
+    }
+
+    void recordEvent(const string& op) {
+        history.push_back({++eventCount, op, sampleFragmentation()});
+    }
+
+    void printHistory() {
+        cout << "\n--- Fragmentation Time Series ---\n";
+        cout << "event  op      used    requested  internal%  external%\n";
+
+        for (auto &e : history) {
+            cout << e.event << "  " << e.op
+                 << "  " << e.sample.used
+                 << "  " << e.sample.requested
+                 << "  " << internal_fragmentation(e.sample) * 100
+                 << "  " << external_fragmentation(e.sample) * 100 << "\n";
+        }
+    }
+
+    void configureSlab(stringstream& parser) {
+        string field;
+        parser >> field;
+
+        if (field == "size") {
+            size_t size = 0;
+            parser >> size;
+
+            if (size > 0)
+                slab_configure(size, {});
+            else
+                cout << "Usage: set slab size <bytes>\n";
+        }
+        else if (field == "classes") {
+            vector<size_t> sizes;
+            size_t sz;
+            while (parser >> sz)
+                sizes.push_back(sz);
+
+            if (!sizes.empty())
+                slab_configure(0, sizes);
+            else
+                cout << "Usage: set slab classes <size> [size ...]\n";
+        }
+        else {
+            cout << "Usage: set slab <size|classes> ...\n";
+        }
+    }
+
+    void setAllocator(const string& type, const string& variant) {
         if (type == "first") {
             mode = AllocatorMode::FIRST;
             cout << "[INFO] Allocation strategy: First Fit\n";
@@ -73,11 +407,250 @@ public:
             mode = AllocatorMode::WORST;
             cout << "[INFO] Allocation strategy: Worst Fit\n";
         } 
+        else if (type == "buddy") {
+            mode = AllocatorMode::BUDDY;
+            cout << "[INFO] Allocation strategy: Buddy System\n";
+        } 
+        else if (type == "tlsf") {
+            mode = AllocatorMode::TLSF;
+            cout << "[INFO] Allocation strategy: TLSF (two-level segregated fit)\n";
+        } 
+        else if (type == "slab") {
+            mode = AllocatorMode::SLAB;
+            cout << "[INFO] Allocation strategy: Slab (size classes)\n";
+        } 
+        else if (type == "arena") {
+            ArenaStrategy strategy = ArenaStrategy::FIRST_FIT;
+            if (!variant.empty() && !parse_arena_strategy(variant.c_str(), strategy)) {
+                cout << "Usage: set allocator arena <first|best|buddy>\n";
+                return;
+            }
+            mode = AllocatorMode::ARENA;
+            arena_frontend_strategy(strategy);
+            cout << "[INFO] Allocation strategy: real-memory arena ("
+                 << arena_strategy_name(strategy) << ")\n";
+        }
         else {
             cout << "[ERROR] Unknown allocator type\n";
         }
     }
 
+    // Replays a file of commands, so every allocator sees the same trace
+    bool runTrace(const string& path) {
+        ifstream trace(path);
+        if (!trace) {
+            cout << "[ERROR] Cannot open trace " << path << "\n";
+            return true;
+        }
+
+        string line;
+        while (getline(trace, line)) {
+            if (line.empty() || line[0] == '#')
+                continue;
+            if (!executeCommand(line))
+                return false;
+        }
+        return true;
+    }
+
+    // Drives the current allocator with a generated malloc/free stream.
+    // Per-op logging is muted; fragmentation is sampled periodically.
+    void runWorkload(stringstream& parser) {
+        static const size_t SAMPLE_EVERY = 1000;
+
+        string dist;
+        size_t events = 0;
+        AllocSpec spec;
+        uint64_t seed;
+        size_t maxSize;
+        parser >> dist >> events;
+        if (parser >> seed)
+            spec.seed = seed;
+        if (parser >> maxSize && maxSize > 0)
+            spec.maxSize = maxSize;
+
+        if (!parse_size_dist(dist, spec.dist) || events == 0) {
+            cout << "Usage: workload <powerlaw|bimodal|phased> <events> [seed] [max size]\n";
+            return;
+        }
+
+        AllocWorkload workload(spec);
+        vector<int> idBySlot;
+        size_t mallocs = 0, frees = 0, failures = 0, live = 0;
+
+        bool verbose = SIM_VERBOSE;
+        SIM_VERBOSE = false;
+
+        for (size_t i = 0; i < events; i++) {
+            AllocEvent ev = workload.next();
+
+            if (ev.isFree) {
+                int id = idBySlot[ev.slot];
+                if (id != -1) {
+                    freeMemory(id);
+                    frees++;
+                    live--;
+                }
+            } else {
+                int id = allocateMemory(ev.size, 1);
+                idBySlot.push_back(id);
+                mallocs++;
+                if (id == -1)
+                    failures++;
+                else
+                    live++;
+            }
+
+            if ((i + 1) % SAMPLE_EVERY == 0)
+                recordEvent("workload");
+        }
+
+        SIM_VERBOSE = verbose;
+        recordEvent("workload");
+
+        cout << "[WORKLOAD] " << dist << " seed " << spec.seed << ": "
+             << events << " events, " << mallocs << " mallocs ("
+             << failures << " failed), " << frees << " frees, "
+             << live << " blocks still live\n";
+    }
+
+    void configureMetrics(stringstream& parser) {
+        string action;
+        parser >> action;
+
+        if (action == "on" || action == "off") {
+            metrics_set_enabled(action == "on");
+            cout << "[INFO] Metrics " << (action == "on" ? "enabled" : "disabled") << "\n";
+        }
+        else if (action == "show") {
+            metrics_print();
+        }
+        else if (action == "reset") {
+            metrics_reset();
+            cout << "[INFO] Metrics reset\n";
+        }
+        else if (action == "interval") {
+            uint64_t events = 0;
+            parser >> events;
+            metrics_set_interval(events);
+            cout << "[INFO] Metrics snapshot every " << events << " events"
+                 << (events ? "" : " (off)") << "\n";
+        }
+        else if (action == "export") {
+            string format, path;
+            parser >> format >> path;
+
+            if (path.empty())
+                cout << "Usage: metrics export <json|csv|prom> <file>\n";
+            else if (metrics_export(format, path))
+                cout << "[OK] Metrics written to " << path << "\n";
+            else
+                cout << "[ERROR] Cannot export " << format << " to " << path << "\n";
+        }
+        else {
+            cout << "Usage: metrics <on|off|show|reset|interval <n>|export <fmt> <file>>\n";
+        }
+    }
+
+    // Every simulated engine is saved, so a restore is independent of
+    // the mode. The real-memory arena holds live pointers and is not
+    // saved; arenaCheck() refuses checkpoints and forks in arena mode.
+    bool saveCheckpoint(const string& path) {
+        SnapshotWriter writer;
+        fit_checkpoint(writer);
+        buddy_checkpoint(writer);
+        slab_checkpoint(writer);
+        tlsf_checkpoint(writer);
+        return writer.save(path);
+    }
+
+    // All or nothing: every engine is parsed and checked before any of
+    // them changes, so a damaged section leaves the whole simulator as
+    // it was. Slab pages are buddy blocks, so the two always travel
+    // together.
+    bool restoreCheckpoint(const SnapshotReader& reader) {
+        if (!fit_restore_stage(reader) || !buddy_restore_stage(reader)
+            || !slab_restore_stage(reader) || !tlsf_restore_stage(reader)) {
+            cout << "[ERROR] Checkpoint is incomplete or damaged\n";
+            return false;
+        }
+
+        fit_restore_commit();
+        buddy_restore_commit();
+        slab_restore_commit();
+        tlsf_restore_commit();
+        recordEvent("restore");
+        return true;
+    }
+
+    bool arenaCheck() {
+        if (mode != AllocatorMode::ARENA)
+            return true;
+        cout << "[ERROR] The real-memory arena cannot be checkpointed or forked; "
+             << "switch to a simulated allocator first\n";
+        return false;
+    }
+
+    void checkpointCommand(stringstream& parser) {
+        string action, path;
+        parser >> action >> path;
+
+        if (!arenaCheck())
+            return;
+
+        if (path.empty() || (action != "save" && action != "load")) {
+            cout << "Usage: checkpoint <save|load> <file>\n";
+        }
+        else if (action == "save") {
+            if (saveCheckpoint(path))
+                cout << "[OK] Checkpoint written to " << path << "\n";
+            else
+                cout << "[ERROR] Cannot write checkpoint " << path << "\n";
+        }
+        else {
+            SnapshotReader reader;
+            if (!reader.open(path))
+                cout << "[ERROR] " << reader.lastError() << "\n";
+            else if (restoreCheckpoint(reader))
+                cout << "[OK] Restored checkpoint " << path << "\n";
+        }
+    }
+
+    // Forks one checkpoint into a run per trace: the file is mapped
+    // once and every trace starts from the same restored state.
+    bool runWhatIf(stringstream& parser) {
+        string path, trace;
+        parser >> path;
+
+        vector<string> traces;
+        while (parser >> trace)
+            traces.push_back(trace);
+
+        if (traces.empty()) {
+            cout << "Usage: whatif <checkpoint> <trace> [trace ...]\n";
+            return true;
+        }
+        if (!arenaCheck())
+            return true;
+
+        SnapshotReader reader;
+        if (!reader.open(path)) {
+            cout << "[ERROR] " << reader.lastError() << "\n";
+            return true;
+        }
+
+        for (auto &t : traces) {
+            if (!restoreCheckpoint(reader))
+                return true;
+
+            cout << "\n===== WHAT-IF: " << t << " =====\n";
+            if (!runTrace(t))
+                return false;
+            printStats();
+        }
+        return true;
+    }
+
     bool executeCommand(const string& input) {
         stringstream parser(input);
         string command;
@@ -95,6 +668,12 @@ public:
 
             if (target == "memory" && size > 0) {
                 init_memory(size);
+                buddy_init(size);
+                slab_init();
+                tlsf_init(size);
+                arena_frontend_init(size);
+                history.clear();
+                eventCount = 0;
                 cout << "[OK] Memory initialized (" << size << " units)\n";
             } else {
                 cout << "Usage: init memory <size>\n";
@@ -103,28 +682,70 @@ public:
 
         else if (command == "set") {
             string target, type;
-            parser >> target >> type;
+            parser >> target;
 
             if (target == "allocator") {
-                setAllocator(type);
+                string variant;
+                parser >> type >> variant;
+                setAllocator(type, variant);
+            } else if (target == "slab") {
+                configureSlab(parser);
+            } else if (target == "header") {
+                parser >> headerSize;
+                set_block_overhead(headerSize, minBlock);
+                buddy_set_header(headerSize);
+                tlsf_set_header(headerSize);
+            } else if (target == "compaction") {
+                string policy;
+                size_t budget = 0;
+                parser >> policy >> budget;
+                if (!set_auto_compaction(policy, budget))
+                    cout << "Usage: set compaction <off|full|incremental|cheapest> [budget]\n";
+            } else if (target == "minblock") {
+                parser >> minBlock;
+                set_block_overhead(headerSize, minBlock);
             } else {
-                cout << "Usage: set allocator <first|best|worst>\n";
+                cout << "Usage: set allocator <first|best|worst|buddy|slab|tlsf>\n";
             }
         }
 
         else if (command == "malloc") {
-            size_t size;
+            size_t size = 0;
+            size_t align = 1;
+            string keyword;
             parser >> size;
 
-            if (size > 0) {
-                int blockId = allocateMemory(size);
+            if (parser >> keyword) {
+                if (keyword != "align" || !(parser >> align))
+                    align = 0;
+            }
+
+            if (size > 0 && align > 0 && (align & (align - 1)) == 0) {
+                int blockId = allocateMemory(size, align);
                 if (blockId != -1) {
                     cout << "[ALLOC SUCCESS] Block ID: " << blockId << "\n";
                 } else {
                     cout << "[ALLOC FAIL] Insufficient memory\n";
                 }
+                recordEvent("malloc");
             } else {
-                cout << "Usage: malloc <size>\n";
+                cout << "Usage: malloc <size> [align <power of two>]\n";
+            }
+        }
+
+        else if (command == "realloc") {
+            int id = -1;
+            size_t size = 0;
+            parser >> id >> size;
+
+            if (id >= 0 && size > 0) {
+                if (reallocMemory(id, size) != -1)
+                    cout << "[REALLOC SUCCESS] Block ID: " << id << "\n";
+                else
+                    cout << "[REALLOC FAIL] Block " << id << " unchanged\n";
+                recordEvent("realloc");
+            } else {
+                cout << "Usage: realloc <id> <size>\n";
             }
         }
 
@@ -133,19 +754,49 @@ public:
             parser >> id;
 
             if (id >= 0) {
-                free_block(id);
-                cout << "[FREE] Block " << id << " released\n";
+                freeMemory(id);
+                recordEvent("free");
             } else {
                 cout << "Usage: free <id>\n";
             }
         }
 
+        else if (command == "compact") {
+            compactMemory(parser);
+        }
+
         else if (command == "dump") {
-            dump_memory();
+            dumpMemory();
         }
 
         else if (command == "stats") {
-            print_stats();
+            printStats();
+        }
+
+        else if (command == "frag") {
+            printHistory();
+        }
+
+        else if (command == "run") {
+            string path;
+            parser >> path;
+            return runTrace(path);
+        }
+
+        else if (command == "workload") {
+            runWorkload(parser);
+        }
+
+        else if (command == "metrics") {
+            configureMetrics(parser);
+        }
+
+        else if (command == "checkpoint") {
+            checkpointCommand(parser);
+        }
+
+        else if (command == "whatif") {
+            return runWhatIf(parser);
         }
 
         else {
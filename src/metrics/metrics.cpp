@@ -0,0 +1,316 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include "../../include/metrics.h"
+
+using namespace std;
+
+/* ================= NAMES ================= */
+
+static const char *COUNTER_NAMES[METRIC_COUNTERS] = {
+    "allocs", "alloc_fails", "frees",
+    "cache_accesses", "cache_misses", "cache_conflicts",
+    "page_accesses", "page_faults",
+    "tlb_accesses", "tlb_misses",
+    "sector_misses", "victim_hits", "victim_misses"
+};
+
+static const char *HISTOGRAM_NAMES[METRIC_HISTOGRAMS] = {
+    "alloc_size_bytes", "alloc_latency_ns",
+    "reuse_distance", "fault_interarrival"
+};
+
+/* ================= STATE ================= */
+
+static vector<MetricsSnapshot> history;   // interval snapshots
+static uint64_t epochNs = 0;
+static mutex historyLock;
+
+static uint64_t now_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void add_shard(MetricsSnapshot &snap, const MetricsShard &s) {
+    for (size_t c = 0; c < METRIC_COUNTERS; c++)
+        snap.counters[c] += s.counters[c].load(memory_order_relaxed);
+    for (size_t h = 0; h < METRIC_HISTOGRAMS; h++) {
+        for (size_t b = 0; b < HIST_BUCKETS; b++)
+            snap.buckets[h][b] += s.buckets[h][b].load(memory_order_relaxed);
+        snap.sums[h] += s.sums[h].load(memory_order_relaxed);
+    }
+}
+
+static uint64_t hist_count(const MetricsSnapshot &snap, size_t h) {
+    uint64_t n = 0;
+    for (size_t b = 0; b < HIST_BUCKETS; b++)
+        n += snap.buckets[h][b];
+    return n;
+}
+
+// Upper bound of the bucket holding the p-th percentile
+static uint64_t hist_percentile(const MetricsSnapshot &snap, size_t h, double p) {
+    uint64_t total = hist_count(snap, h);
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(p / 100.0 * total + 0.5), seen = 0;
+    for (size_t b = 0; b < HIST_BUCKETS; b++) {
+        seen += snap.buckets[h][b];
+        if (seen >= rank && seen > 0)
+            return b == 0 ? 0 : (b >= 64 ? UINT64_MAX : (1ULL << b) - 1);
+    }
+    return UINT64_MAX;
+}
+
+/* ================= SNAPSHOTS ================= */
+
+// Totals over retired and running threads. Counters of running
+// threads are read relaxed, so a snapshot may be a few events stale.
+MetricsSnapshot metrics_snapshot() {
+    MetricsSnapshot snap = {};
+    snap.timeNs = epochNs ? now_ns() - epochNs : 0;
+
+    MetricsRegistry &r = metrics_registry();
+    lock_guard<mutex> guard(r.lock);
+
+    add_shard(snap, r.retired);
+    for (MetricsShard *s : r.shards)
+        add_shard(snap, *s);
+
+    for (auto &h : r.heatmaps) {
+        vector<uint64_t> cells(h.cells);
+        for (size_t i = 0; i < h.cells; i++)
+            cells[i] = h.counts[i].load(memory_order_relaxed);
+        snap.heatmaps.push_back({h.name, cells});
+    }
+
+    return snap;
+}
+
+void metrics_interval_snapshot() {
+    MetricsSnapshot snap = metrics_snapshot();
+    lock_guard<mutex> guard(historyLock);
+    snap.seq = history.size() + 1;
+    history.push_back(snap);
+}
+
+void metrics_set_enabled(bool on) {
+    if (on && !epochNs)
+        epochNs = now_ns();
+    METRICS_ENABLED = on;
+}
+
+void metrics_set_interval(uint64_t events) {
+    metrics_registry().interval = events;
+}
+
+static void zero_shard(MetricsShard &s) {
+    for (auto &c : s.counters)
+        c.store(0, memory_order_relaxed);
+    for (auto &row : s.buckets)
+        for (auto &b : row)
+            b.store(0, memory_order_relaxed);
+    for (auto &sum : s.sums)
+        sum.store(0, memory_order_relaxed);
+}
+
+// Reuse bookkeeping of other threads is left alone: only the owner may touch it
+void metrics_reset() {
+    MetricsRegistry &r = metrics_registry();
+    {
+        lock_guard<mutex> guard(r.lock);
+        zero_shard(r.retired);
+        for (MetricsShard *s : r.shards)
+            zero_shard(*s);
+        for (auto &h : r.heatmaps)
+            for (size_t i = 0; i < h.cells; i++)
+                h.counts[i].store(0, memory_order_relaxed);
+    }
+
+    MetricsShard &own = metrics_shard();
+    own.ticks = 0;
+    own.reuse.clear();
+
+    lock_guard<mutex> guard(historyLock);
+    history.clear();
+    epochNs = METRICS_ENABLED ? now_ns() : 0;
+}
+
+/* ================= TEXT SUMMARY ================= */
+
+void metrics_print() {
+    MetricsSnapshot snap = metrics_snapshot();
+    size_t intervals;
+    {
+        lock_guard<mutex> guard(historyLock);
+        intervals = history.size();
+    }
+
+    cout << "\n--- Metrics (" << (METRICS_ENABLED ? "enabled" : "disabled")
+         << ", " << intervals << " interval snapshots) ---\n";
+
+    for (size_t c = 0; c < METRIC_COUNTERS; c++)
+        cout << left << setw(22) << COUNTER_NAMES[c] << ": " << snap.counters[c] << "\n";
+
+    cout << "\nhistogram              count      mean       p50       p99\n";
+    for (size_t h = 0; h < METRIC_HISTOGRAMS; h++) {
+        uint64_t n = hist_count(snap, h);
+        cout << left << setw(20) << HISTOGRAM_NAMES[h] << right
+             << setw(8) << n
+             << setw(10) << fixed << setprecision(1)
+             << (n ? (double)snap.sums[h] / n : 0.0)
+             << setw(10) << hist_percentile(snap, h, 50)
+             << setw(10) << hist_percentile(snap, h, 99) << "\n";
+    }
+    cout << left;
+
+    for (auto &hm : snap.heatmaps) {
+        vector<size_t> order(hm.second.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return hm.second[a] > hm.second[b];
+        });
+
+        cout << "\nConflict heatmap " << hm.first << " (" << hm.second.size()
+             << " sets, hottest):";
+        for (size_t i = 0; i < order.size() && i < 5 && hm.second[order[i]]; i++)
+            cout << " set " << order[i] << "=" << hm.second[order[i]];
+        cout << "\n";
+    }
+}
+
+/* ================= EXPORT ================= */
+
+static void write_json_snapshot(ostream &out, const MetricsSnapshot &snap) {
+    out << "{\"seq\": " << snap.seq << ", \"time_ns\": " << snap.timeNs
+        << ", \"counters\": {";
+    for (size_t c = 0; c < METRIC_COUNTERS; c++)
+        out << (c ? ", " : "") << "\"" << COUNTER_NAMES[c] << "\": " << snap.counters[c];
+
+    out << "}, \"histograms\": {";
+    for (size_t h = 0; h < METRIC_HISTOGRAMS; h++) {
+        out << (h ? ", " : "") << "\"" << HISTOGRAM_NAMES[h] << "\": {\"sum\": "
+            << snap.sums[h] << ", \"log2_buckets\": [";
+        for (size_t b = 0; b < HIST_BUCKETS; b++)
+            out << (b ? ", " : "") << snap.buckets[h][b];
+        out << "]}";
+    }
+
+    out << "}, \"heatmaps\": {";
+    for (size_t i = 0; i < snap.heatmaps.size(); i++) {
+        out << (i ? ", " : "") << "\"" << snap.heatmaps[i].first << "/"
+            << snap.heatmaps[i].second.size() << "\": [";
+        for (size_t k = 0; k < snap.heatmaps[i].second.size(); k++)
+            out << (k ? ", " : "") << snap.heatmaps[i].second[k];
+        out << "]";
+    }
+    out << "}}";
+}
+
+// Interval snapshots followed by the current totals
+static void export_json(ostream &out) {
+    out << "{\n  \"intervals\": [\n";
+    for (size_t i = 0; i < history.size(); i++) {
+        out << "    ";
+        write_json_snapshot(out, history[i]);
+        out << (i + 1 < history.size() ? ",\n" : "\n");
+    }
+    out << "  ],\n  \"final\": ";
+    write_json_snapshot(out, metrics_snapshot());
+    out << "\n}\n";
+}
+
+// Long format: one value per row, easy to pivot
+static void write_csv_rows(ostream &out, const MetricsSnapshot &snap) {
+    string prefix = to_string(snap.seq) + "," + to_string(snap.timeNs) + ",";
+
+    for (size_t c = 0; c < METRIC_COUNTERS; c++)
+        out << prefix << COUNTER_NAMES[c] << ",," << snap.counters[c] << "\n";
+
+    for (size_t h = 0; h < METRIC_HISTOGRAMS; h++) {
+        out << prefix << HISTOGRAM_NAMES[h] << ",sum," << snap.sums[h] << "\n";
+        for (size_t b = 0; b < HIST_BUCKETS; b++) {
+            if (snap.buckets[h][b])
+                out << prefix << HISTOGRAM_NAMES[h] << ",bucket" << b << ","
+                    << snap.buckets[h][b] << "\n";
+        }
+    }
+
+    for (auto &hm : snap.heatmaps) {
+        for (size_t k = 0; k < hm.second.size(); k++) {
+            if (hm.second[k])
+                out << prefix << "conflicts_" << hm.first << "/" << hm.second.size()
+                    << ",set" << k << ","
+                    << hm.second[k] << "\n";
+        }
+    }
+}
+
+static void export_csv(ostream &out) {
+    out << "seq,time_ns,metric,label,value\n";
+    for (auto &snap : history)
+        write_csv_rows(out, snap);
+    write_csv_rows(out, metrics_snapshot());
+}
+
+// Prometheus text exposition format, current totals only
+static void export_prometheus(ostream &out) {
+    MetricsSnapshot snap = metrics_snapshot();
+
+    for (size_t c = 0; c < METRIC_COUNTERS; c++) {
+        out << "# TYPE memsim_" << COUNTER_NAMES[c] << "_total counter\n"
+            << "memsim_" << COUNTER_NAMES[c] << "_total " << snap.counters[c] << "\n";
+    }
+
+    for (size_t h = 0; h < METRIC_HISTOGRAMS; h++) {
+        string name = string("memsim_") + HISTOGRAM_NAMES[h];
+        out << "# TYPE " << name << " histogram\n";
+
+        // Prometheus buckets are cumulative, upper bounds inclusive
+        uint64_t cumulative = 0;
+        size_t last = 0;
+        for (size_t b = 0; b < HIST_BUCKETS; b++)
+            if (snap.buckets[h][b])
+                last = b;
+
+        for (size_t b = 0; b <= last && b < 64; b++) {
+            cumulative += snap.buckets[h][b];
+            uint64_t le = b == 0 ? 0 : (1ULL << b) - 1;
+            out << name << "_bucket{le=\"" << le << "\"} " << cumulative << "\n";
+        }
+        out << name << "_bucket{le=\"+Inf\"} " << hist_count(snap, h) << "\n"
+            << name << "_sum " << snap.sums[h] << "\n"
+            << name << "_count " << hist_count(snap, h) << "\n";
+    }
+
+    out << "# TYPE memsim_cache_set_conflicts_total counter\n";
+    for (auto &hm : snap.heatmaps) {
+        for (size_t k = 0; k < hm.second.size(); k++) {
+            out << "memsim_cache_set_conflicts_total{cache=\"" << hm.first
+                << "\",sets=\"" << hm.second.size() << "\",set=\"" << k << "\"} "
+                << hm.second[k] << "\n";
+        }
+    }
+}
+
+bool metrics_export(const string &format, const string &path) {
+    if (format != "json" && format != "csv" && format != "prom")
+        return false;
+
+    ofstream out(path);
+    if (!out)
+        return false;
+
+    lock_guard<mutex> guard(historyLock);
+    if (format == "json")
+        export_json(out);
+    else if (format == "csv")
+        export_csv(out);
+    else
+        export_prometheus(out);
+
+    return true;
+}
@@ -0,0 +1,473 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+#include "../../include/sim_log.h"
+#include "../../include/workload.h"
+#include "../../include/cache.h"
+#include "../../include/virtual_memory.h"
+
+using namespace std;
+
+/*
+ ALLOCATOR -> VM -> CACHE PIPELINE
+ ---------------------------------
+ - Stage 1 replays a generated malloc/free workload on one allocator;
+   every new object is written line by line and live objects are
+   read at random offsets, so heap placement decides the addresses
+ - Stage 2 translates them through the TLB and page table
+ - Stage 3 runs the physical addresses through L1 / L2
+ - Stages run on their own threads, linked by batched SPSC queues
+ - Every allocator policy sees the same seeded workload
+ - Warm start: a warm-up phase is snapshotted once (heap engines, VM
+   and caches) and forked into one measured run per seed, so every
+   fork starts from the same warmed state instead of a cold heap
+*/
+
+/* -------- Allocator APIs (implemented elsewhere) -------- */
+
+void init_memory(size_t size);
+int first_fit_malloc(size_t size, size_t align);
+int best_fit_malloc(size_t size, size_t align);
+int worst_fit_malloc(size_t size, size_t align);
+void free_block(int id);
+size_t fit_block_address(int id);
+void fit_checkpoint(SnapshotWriter &w);
+bool fit_restore_stage(const SnapshotReader &r);
+void fit_restore_commit();
+
+void buddy_init(size_t memorySize);
+int buddy_malloc_block(size_t size, size_t align);
+void buddy_free_block(int id);
+size_t buddy_block_address(int id);
+void buddy_checkpoint(SnapshotWriter &w);
+bool buddy_restore_stage(const SnapshotReader &r);
+void buddy_restore_commit();
+
+void slab_init();
+int slab_malloc(size_t size, size_t align);
+void slab_free(int id);
+size_t slab_block_address(int id);
+void slab_checkpoint(SnapshotWriter &w);
+bool slab_restore_stage(const SnapshotReader &r);
+void slab_restore_commit();
+
+void tlsf_init(size_t memorySize);
+int tlsf_malloc(size_t size, size_t align);
+void tlsf_free(int id);
+size_t tlsf_block_address(int id);
+void tlsf_checkpoint(SnapshotWriter &w);
+bool tlsf_restore_stage(const SnapshotReader &r);
+void tlsf_restore_commit();
+
+/* ================= CONFIGURATION ================= */
+
+static const size_t HEAP_SIZE = 4UL * 1024 * 1024;   // virtual heap
+static const size_t PHYS_SIZE = 1UL * 1024 * 1024;   // physical frames
+static const size_t PAGE_SIZE = 4096;
+static const size_t TLB_ENTRIES = 64;
+static const size_t LINE_SIZE = 64;
+static const size_t READS_PER_EVENT = 4;             // loads from live objects
+
+struct Policy {
+    const char *name;
+    int (*malloc)(size_t, size_t);
+    void (*free)(int);
+    size_t (*address)(int);
+};
+
+static const Policy POLICIES[] = {
+    {"first", first_fit_malloc, free_block, fit_block_address},
+    {"best", best_fit_malloc, free_block, fit_block_address},
+    {"worst", worst_fit_malloc, free_block, fit_block_address},
+    {"buddy", buddy_malloc_block, buddy_free_block, buddy_block_address},
+    {"slab", slab_malloc, slab_free, slab_block_address},
+    {"tlsf", tlsf_malloc, tlsf_free, tlsf_block_address},
+};
+
+/* ================= STAGE LINKS ================= */
+
+typedef SpscQueue<AddressBatch> Link;
+
+// Producer side: fills batches in place, publishes when full
+class BatchWriter {
+private:
+    Link &link;
+    AddressBatch *cur;
+
+public:
+    explicit BatchWriter(Link &l) : link(l), cur(nullptr) {}
+
+    void push(uint64_t addr) {
+        if (!cur) {
+            while (!(cur = link.writeSlot()))
+                this_thread::yield();
+            cur->count = 0;
+        }
+
+        cur->addrs[cur->count++] = addr;
+        if (cur->count == WORKLOAD_BATCH) {
+            link.publish();
+            cur = nullptr;
+        }
+    }
+
+    void finish() {
+        if (cur && cur->count > 0)
+            link.publish();
+        cur = nullptr;
+        link.close();
+    }
+};
+
+// Consumer side: nullptr once the producer has closed the link
+static AddressBatch *next_batch(Link &link) {
+    while (true) {
+        AddressBatch *b = link.readSlot();
+        if (b)
+            return b;
+        if (link.isClosed())
+            return link.readSlot();
+        this_thread::yield();
+    }
+}
+
+/* ================= STAGES ================= */
+
+struct HeapStats {
+    size_t mallocs;
+    size_t failures;
+    size_t frees;
+    size_t highWater;   // highest heap address touched
+};
+
+static const uint32_t RESIDENT = UINT32_MAX;   // slot of a warm-up object
+
+struct LiveObject {
+    int id;
+    uint32_t slot;
+    size_t addr;
+    size_t size;
+};
+
+// Objects already in `live` (a warm start's resident set) are read like
+// any other but never freed by the workload. With `drain` the engine is
+// left empty for the next policy; otherwise the survivors stay in
+// `live`, marked resident, for the caller to snapshot.
+static void heap_stage(const Policy &policy, const AllocSpec &spec, size_t events,
+                       bool drain, vector<LiveObject> &live, Link &out, HeapStats &stats) {
+    AllocWorkload workload(spec);
+    Rng rng(spec.seed ^ 0xA5A5A5A5A5A5A5A5ULL);
+    BatchWriter writer(out);
+
+    vector<int> liveIndex;   // workload slot -> index in live, -1 if none
+    stats = {};
+    for (auto &obj : live)
+        stats.highWater = max(stats.highWater, obj.addr + obj.size);
+
+    for (size_t e = 0; e < events; e++) {
+        AllocEvent ev = workload.next();
+
+        if (ev.isFree) {
+            int idx = liveIndex[ev.slot];
+            if (idx != -1) {
+                policy.free(live[idx].id);
+                live[idx] = live.back();
+                if (live[idx].slot != RESIDENT)
+                    liveIndex[live[idx].slot] = idx;
+                live.pop_back();
+                liveIndex[ev.slot] = -1;
+                stats.frees++;
+            }
+        } else {
+            stats.mallocs++;
+            int id = policy.malloc(ev.size, 1);
+            liveIndex.push_back(-1);
+
+            if (id == -1) {
+                stats.failures++;
+            } else {
+                size_t addr = policy.address(id);
+                liveIndex[ev.slot] = live.size();
+                live.push_back({id, ev.slot, addr, ev.size});
+                stats.highWater = max(stats.highWater, addr + ev.size);
+
+                // initialise the object
+                for (size_t a = addr & ~(LINE_SIZE - 1); a < addr + ev.size; a += LINE_SIZE)
+                    writer.push(a);
+            }
+        }
+
+        for (size_t r = 0; r < READS_PER_EVENT && !live.empty(); r++) {
+            const LiveObject &obj = live[rng.below(live.size())];
+            writer.push(obj.addr + rng.below(obj.size));
+        }
+    }
+
+    if (drain) {
+        for (auto &obj : live)
+            policy.free(obj.id);
+        live.clear();
+    } else {
+        for (auto &obj : live)
+            obj.slot = RESIDENT;
+    }
+
+    writer.finish();
+}
+
+static void translate_stage(VirtualMemory &vm, Link &in, Link &out) {
+    BatchWriter writer(out);
+
+    while (AddressBatch *b = next_batch(in)) {
+        for (size_t i = 0; i < b->count; i++)
+            writer.push(vm.translate(b->addrs[i]));
+        in.release();
+    }
+
+    writer.finish();
+}
+
+static size_t cache_stage(CacheHierarchy &caches, Link &in) {
+    size_t accesses = 0;
+
+    while (AddressBatch *b = next_batch(in)) {
+        for (size_t i = 0; i < b->count; i++)
+            caches.access(b->addrs[i]);
+        accesses += b->count;
+        in.release();
+    }
+
+    return accesses;
+}
+
+/* ================= DRIVER ================= */
+
+struct RunResult {
+    HeapStats heap;
+    size_t accesses;
+    size_t tlbHits, tlbMisses, faults;
+    double l1HitRate, l2HitRate;
+    size_t cycles;
+    double seconds;
+    double restoreMs;   // warm start only: snapshot to ready-to-run
+};
+
+static void init_engines() {
+    init_memory(HEAP_SIZE);
+    buddy_init(HEAP_SIZE);
+    slab_init();
+    tlsf_init(HEAP_SIZE);
+}
+
+static CacheHierarchy make_caches() {
+    return CacheHierarchy(Cache(32 * 1024, LINE_SIZE, 8, ReplacePolicy::LRU, 4),
+                          Cache(256 * 1024, LINE_SIZE, 8, ReplacePolicy::LRU, 12));
+}
+
+static double rate(size_t hits, size_t misses) {
+    return hits + misses ? (double)hits / (hits + misses) : 0.0;
+}
+
+// One pass of the three stages. VM and cache counters are reported as
+// deltas, so a run forked from a warm snapshot only shows its own part.
+static RunResult run_stages(const Policy &policy, const AllocSpec &spec, size_t events,
+                            bool drain, vector<LiveObject> &live,
+                            VirtualMemory &vm, CacheHierarchy &caches) {
+    size_t tlbHits = vm.tlb.hits, tlbMisses = vm.tlb.misses, faults = vm.faults;
+    size_t l1Hits = caches.L1.hits, l1Misses = caches.L1.misses;
+    size_t l2Hits = caches.L2.hits, l2Misses = caches.L2.misses;
+    size_t cycles = caches.totalTime;
+
+    Link heapToVm(WORKLOAD_QUEUE_DEPTH);
+    Link vmToCache(WORKLOAD_QUEUE_DEPTH);
+    RunResult res = {};
+
+    auto begin = chrono::steady_clock::now();
+
+    thread heap(heap_stage, cref(policy), cref(spec), events, drain, ref(live),
+                ref(heapToVm), ref(res.heap));
+    thread mmu(translate_stage, ref(vm), ref(heapToVm), ref(vmToCache));
+    res.accesses = cache_stage(caches, vmToCache);
+
+    heap.join();
+    mmu.join();
+
+    auto end = chrono::steady_clock::now();
+
+    res.tlbHits = vm.tlb.hits - tlbHits;
+    res.tlbMisses = vm.tlb.misses - tlbMisses;
+    res.faults = vm.faults - faults;
+    res.l1HitRate = rate(caches.L1.hits - l1Hits, caches.L1.misses - l1Misses);
+    res.l2HitRate = rate(caches.L2.hits - l2Hits, caches.L2.misses - l2Misses);
+    res.cycles = caches.totalTime - cycles;
+    res.seconds = chrono::duration<double>(end - begin).count();
+    return res;
+}
+
+static RunResult run_policy(const Policy &policy, const AllocSpec &spec, size_t events) {
+    init_engines();
+
+    VirtualMemory vm(HEAP_SIZE, PHYS_SIZE, PAGE_SIZE, TLB_ENTRIES);
+    CacheHierarchy caches = make_caches();
+    vector<LiveObject> live;
+    return run_stages(policy, spec, events, true, live, vm, caches);
+}
+
+// Every engine is saved, as in memsim: slab pages are buddy blocks
+static bool save_warm(const string &path, const VirtualMemory &vm,
+                      const CacheHierarchy &caches) {
+    SnapshotWriter writer;
+    fit_checkpoint(writer);
+    buddy_checkpoint(writer);
+    slab_checkpoint(writer);
+    tlsf_checkpoint(writer);
+    vm.checkpoint(writer);
+    writer.section(SEC_CACHE);
+    caches.checkpoint(writer);
+    return writer.save(path);
+}
+
+static bool restore_warm(const SnapshotReader &reader, VirtualMemory &vm,
+                         CacheHierarchy &caches) {
+    SectionCursor cur;
+    if (!fit_restore_stage(reader) || !buddy_restore_stage(reader)
+        || !slab_restore_stage(reader) || !tlsf_restore_stage(reader)
+        || !vm.restore(reader) || !reader.section(SEC_CACHE, cur)
+        || !caches.restore(cur))
+        return false;
+
+    fit_restore_commit();
+    buddy_restore_commit();
+    slab_restore_commit();
+    tlsf_restore_commit();
+    return true;
+}
+
+// Runs `warm` events of the base seed, snapshots the warmed engines,
+// VM and caches, then forks one measured run per seed (base + 1 ...)
+// from the mapped file. Warm-up survivors stay resident in every fork.
+static bool run_forks(const Policy &policy, const AllocSpec &spec, size_t warm,
+                      size_t events, size_t forks, vector<RunResult> &out) {
+    init_engines();
+
+    VirtualMemory vm(HEAP_SIZE, PHYS_SIZE, PAGE_SIZE, TLB_ENTRIES);
+    CacheHierarchy caches = make_caches();
+    vector<LiveObject> resident;
+    run_stages(policy, spec, warm, false, resident, vm, caches);
+
+    string path = "/tmp/memsim_pipeline_" + to_string(getpid()) + ".snap";
+    SnapshotReader reader;
+    bool ok = save_warm(path, vm, caches) && reader.open(path);
+    if (!ok)
+        cout << "[ERROR] Cannot snapshot the warm state of " << policy.name << "\n";
+
+    for (size_t k = 0; ok && k < forks; k++) {
+        auto begin = chrono::steady_clock::now();
+        VirtualMemory forkVm(HEAP_SIZE, PHYS_SIZE, PAGE_SIZE, TLB_ENTRIES);
+        CacheHierarchy forkCaches = make_caches();
+        if (!restore_warm(reader, forkVm, forkCaches)) {
+            cout << "[ERROR] Warm snapshot of " << policy.name << " does not restore\n";
+            ok = false;
+            break;
+        }
+        double restoreMs = chrono::duration<double, milli>(
+            chrono::steady_clock::now() - begin).count();
+
+        AllocSpec forkSpec = spec;
+        forkSpec.seed = spec.seed + 1 + k;
+        vector<LiveObject> live = resident;
+        RunResult r = run_stages(policy, forkSpec, events, false, live, forkVm, forkCaches);
+        r.restoreMs = restoreMs;
+        out.push_back(r);
+    }
+
+    reader.close();
+    unlink(path.c_str());
+    return ok;
+}
+
+static void print_row(const string &label, const RunResult &r, bool warm) {
+    size_t tlbTotal = r.tlbHits + r.tlbMisses;
+
+    cout << left << setw(12) << label << right
+         << setw(10) << r.heap.mallocs << setw(8) << r.heap.failures
+         << setw(11) << r.heap.highWater << setw(11) << r.accesses
+         << fixed << setprecision(2)
+         << setw(8) << (tlbTotal ? 100.0 * r.tlbHits / tlbTotal : 0.0)
+         << setw(9) << r.faults
+         << setw(8) << r.l1HitRate * 100 << setw(8) << r.l2HitRate * 100
+         << setw(12) << (r.accesses ? (double)r.cycles / r.accesses : 0.0)
+         << setw(11) << (r.seconds > 0 ? r.accesses / r.seconds / 1e6 : 0.0);
+    if (warm)
+        cout << setw(12) << r.restoreMs;
+    cout << "\n";
+}
+
+// Usage: memsim_pipeline [events] [seed] [powerlaw|bimodal|phased] [max size]
+//                        [warm events] [forks]
+int main(int argc, char **argv) {
+    size_t events = 100000;
+    size_t warm = 0, forks = 1;
+    AllocSpec spec;
+    spec.maxSize = 1024;   // keeps every request inside the slab classes
+
+    if (argc > 1)
+        events = strtoull(argv[1], nullptr, 10);
+    if (argc > 2)
+        spec.seed = strtoull(argv[2], nullptr, 10);
+    if (argc > 3 && !parse_size_dist(argv[3], spec.dist)) {
+        cout << "Usage: memsim_pipeline [events] [seed] [powerlaw|bimodal|phased] [max size]"
+             << " [warm events] [forks]\n";
+        return 2;
+    }
+    if (argc > 4)
+        spec.maxSize = strtoull(argv[4], nullptr, 10);
+    if (argc > 5)
+        warm = strtoull(argv[5], nullptr, 10);
+    if (argc > 6)
+        forks = max<size_t>(1, strtoull(argv[6], nullptr, 10));
+
+    SIM_VERBOSE = false;
+
+    cout << "=== ALLOCATOR -> VM -> CACHE PIPELINE ===\n";
+    cout << events << " workload events, seed " << spec.seed
+         << ", sizes " << spec.minSize << ".." << spec.maxSize
+         << ", heap " << HEAP_SIZE << ", phys " << PHYS_SIZE
+         << ", TLB " << TLB_ENTRIES << " entries\n";
+    if (warm)
+        cout << "Warm start: " << warm << " events of seed " << spec.seed
+             << ", forked into seeds " << spec.seed + 1 << ".." << spec.seed + forks << "\n";
+    cout << "\n";
+
+    cout << left << setw(12) << (warm ? "policy:seed" : "policy") << right
+         << setw(10) << "mallocs" << setw(8) << "fails"
+         << setw(11) << "highwater" << setw(11) << "accesses"
+         << setw(8) << "TLB%" << setw(9) << "faults"
+         << setw(8) << "L1%" << setw(8) << "L2%"
+         << setw(12) << "cycles/acc" << setw(11) << "Macc/sec";
+    if (warm)
+        cout << setw(12) << "restore ms";
+    cout << "\n";
+
+    for (const Policy &p : POLICIES) {
+        if (!warm) {
+            print_row(p.name, run_policy(p, spec, events), false);
+            continue;
+        }
+
+        vector<RunResult> runs;
+        if (!run_forks(p, spec, warm, events, forks, runs))
+            return 1;
+        for (size_t k = 0; k < runs.size(); k++)
+            print_row(string(p.name) + ":" + to_string(spec.seed + 1 + k), runs[k], true);
+    }
+
+    return 0;
+}
@@ -0,0 +1,719 @@
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "../../include/fragmentation.h"
+#include "../../include/sim_log.h"
+#include "../../include/snapshot.h"
+
+using namespace std;
+
+/*
+ SIZE-CLASS SLAB ALLOCATOR
+ -------------------------
+ - Fixed object sizes (size classes), jemalloc/tcmalloc style
+ - Each slab is one page-sized block carved from the buddy allocator
+ - Per-slab free bitmap (1 bit per object slot)
+ - Partial / full / empty slab lists per size class
+ - Internal fragmentation reported per size class
+*/
+
+/* -------- Buddy backing (implemented elsewhere) -------- */
+
+size_t buddy_malloc(size_t request, size_t align);
+void buddy_free(size_t addr, size_t originalSize);
+
+/* ================= SLAB STATE ================= */
+
+struct Slab {
+    size_t base;              // address of the backing buddy block
+    size_t capacity;          // object slots in this slab
+    size_t used;              // slots currently handed out
+    int sizeClass;            // owning size class index
+    vector<uint64_t> bitmap;  // bit set = slot allocated
+    bool live;                // false once returned to buddy
+
+    Slab() : base(0), capacity(0), used(0), sizeClass(-1), live(false) {}
+};
+
+struct SizeClass {
+    size_t objSize;
+    vector<int> partial;      // slab indices with free and used slots
+    vector<int> full;         // slab indices with no free slot
+    vector<int> empty;        // cached slabs with no used slot
+    size_t liveObjects;
+    size_t requestedBytes;    // sum of requested sizes of live objects
+
+    SizeClass(size_t s)
+        : objSize(s), liveObjects(0), requestedBytes(0) {}
+};
+
+struct SlabObject {
+    int slab;
+    size_t slot;
+    size_t requested;
+    size_t align;             // alignment asked for, kept across realloc
+};
+
+static size_t SLAB_SIZE = 4096;
+static size_t MAX_EMPTY_SLABS = 1;   // empty slabs cached per class
+static vector<size_t> CLASS_SIZES = {8, 16, 32, 64, 128, 256, 512, 1024};
+
+static vector<SizeClass> classes;
+static vector<Slab> slabs;
+static vector<int> deadSlabs;        // reusable entries in slabs
+static unordered_map<int, SlabObject> objects;
+static int NEXT_ID = 1;
+
+static int success_count = 0;
+static int failure_count = 0;
+
+static int realloc_in_place = 0;
+static int realloc_moved = 0;
+static size_t realloc_copy_bytes = 0;
+
+/* ================= INTERNAL HELPERS ================= */
+
+// Smallest size class that holds the request. Slabs are aligned to
+// SLAB_SIZE, so slot addresses are aligned whenever objSize is.
+static int class_for(size_t request, size_t align) {
+    if (align > SLAB_SIZE)
+        return -1;
+
+    for (size_t i = 0; i < classes.size(); i++) {
+        if (classes[i].objSize >= request && classes[i].objSize % align == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void move_slab(vector<int> &from, vector<int> &to, int s) {
+    auto it = find(from.begin(), from.end(), s);
+    if (it != from.end())
+        from.erase(it);
+    to.push_back(s);
+}
+
+// carve a fresh slab for a size class out of the buddy allocator
+static int new_slab(int cls) {
+    size_t addr = buddy_malloc(SLAB_SIZE, SLAB_SIZE);
+    if (addr == SIZE_MAX)
+        return -1;
+
+    int s;
+    if (!deadSlabs.empty()) {
+        s = deadSlabs.back();
+        deadSlabs.pop_back();
+    } else {
+        s = slabs.size();
+        slabs.emplace_back();
+    }
+
+    Slab &slab = slabs[s];
+    slab.base = addr;
+    slab.capacity = SLAB_SIZE / classes[cls].objSize;
+    slab.used = 0;
+    slab.sizeClass = cls;
+    slab.live = true;
+    slab.bitmap.assign((slab.capacity + 63) / 64, 0);
+
+    // slots past capacity are marked allocated so they are never handed out
+    size_t tail = slab.capacity % 64;
+    if (tail != 0)
+        slab.bitmap.back() = ~0ULL << tail;
+
+    return s;
+}
+
+static void release_slab(int s) {
+    Slab &slab = slabs[s];
+    buddy_free(slab.base, SLAB_SIZE);
+    slab.live = false;
+    slab.bitmap.clear();
+    deadSlabs.push_back(s);
+}
+
+// claim the first clear bit in the slab bitmap
+static size_t take_slot(Slab &slab) {
+    for (size_t w = 0; w < slab.bitmap.size(); w++) {
+        uint64_t freeBits = ~slab.bitmap[w];
+        if (freeBits != 0) {
+            size_t bit = __builtin_ctzll(freeBits);
+            slab.bitmap[w] |= (1ULL << bit);
+            return w * 64 + bit;
+        }
+    }
+    return SIZE_MAX;
+}
+
+/* ================= CONFIGURATION ================= */
+
+// slabSize == 0 or empty sizes keep the current setting
+bool slab_configure(size_t slabSize, const vector<size_t> &sizes) {
+    if (slabSize == 0)
+        slabSize = SLAB_SIZE;
+
+    if (!objects.empty()) {
+        SIM_LOG << "[SLAB] Cannot reconfigure while objects are live\n";
+        return false;
+    }
+
+    if ((slabSize & (slabSize - 1)) != 0) {
+        SIM_LOG << "[SLAB] Slab size must be a power of two\n";
+        return false;
+    }
+
+    vector<size_t> sorted = sizes.empty() ? CLASS_SIZES : sizes;
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+
+    if (sorted.empty() || sorted.front() == 0 || sorted.back() > slabSize) {
+        SIM_LOG << "[SLAB] Size classes must be in (0, " << slabSize << "]\n";
+        return false;
+    }
+
+    // cached empty slabs were sized for the old layout
+    for (auto &sc : classes) {
+        for (int s : sc.empty)
+            release_slab(s);
+        sc.empty.clear();
+    }
+
+    SLAB_SIZE = slabSize;
+    CLASS_SIZES = sorted;
+
+    if (!classes.empty()) {
+        classes.clear();
+        for (size_t sz : CLASS_SIZES)
+            classes.emplace_back(sz);
+    }
+
+    SIM_LOG << "[SLAB] Slab size " << SLAB_SIZE << ", " << CLASS_SIZES.size()
+            << " size classes\n";
+    return true;
+}
+
+/* ================= INITIALIZATION ================= */
+
+// buddy_init() must already have been called for the backing memory
+void slab_init() {
+    classes.clear();
+    slabs.clear();
+    deadSlabs.clear();
+    objects.clear();
+    NEXT_ID = 1;
+    success_count = 0;
+    failure_count = 0;
+    realloc_in_place = 0;
+    realloc_moved = 0;
+    realloc_copy_bytes = 0;
+
+    for (size_t sz : CLASS_SIZES)
+        classes.emplace_back(sz);
+
+    SIM_LOG << "[SLAB INIT] Slab size = " << SLAB_SIZE << "\n";
+}
+
+/* ================= ALLOCATION ================= */
+
+// Claims a slot in size class `cls`; false when no backing slab can be
+// carved. Ids and success / failure counts are left to the caller.
+static bool take_object(int cls, size_t request, size_t align, SlabObject &obj) {
+    SizeClass &sc = classes[cls];
+    int s;
+
+    if (!sc.partial.empty()) {
+        s = sc.partial.back();
+    } else if (!sc.empty.empty()) {
+        s = sc.empty.back();
+        move_slab(sc.empty, sc.partial, s);
+    } else {
+        s = new_slab(cls);
+        if (s == -1)
+            return false;
+        sc.partial.push_back(s);
+    }
+
+    Slab &slab = slabs[s];
+    size_t slot = take_slot(slab);
+    slab.used++;
+
+    if (slab.used == slab.capacity)
+        move_slab(sc.partial, sc.full, s);
+
+    obj = {s, slot, request, align};
+    sc.liveObjects++;
+    sc.requestedBytes += request;
+    return true;
+}
+
+int slab_malloc(size_t request, size_t align) {
+    if (classes.empty()) {
+        failure_count++;
+        SIM_LOG << "[SLAB] Allocation failed (not initialized)\n";
+        return -1;
+    }
+
+    int cls = class_for(request, align);
+    if (cls == -1) {
+        failure_count++;
+        SIM_LOG << "[SLAB] Allocation failed (no size class fits)\n";
+        return -1;
+    }
+
+    SlabObject obj;
+    if (!take_object(cls, request, align, obj)) {
+        failure_count++;
+        SIM_LOG << "[SLAB] Allocation failed (no backing slab)\n";
+        return -1;
+    }
+
+    int id = NEXT_ID++;
+    objects[id] = obj;
+    success_count++;
+
+    SIM_LOG << "[SLAB] Allocated block " << id << " at "
+            << slabs[obj.slab].base + obj.slot * classes[cls].objSize
+            << " (class " << classes[cls].objSize << ")\n";
+    return id;
+}
+
+/* ================= DEALLOCATION ================= */
+
+void slab_free(int id) {
+    auto it = objects.find(id);
+    if (it == objects.end()) {
+        SIM_LOG << "[SLAB] Invalid block id\n";
+        return;
+    }
+
+    SlabObject obj = it->second;
+    objects.erase(it);
+
+    Slab &slab = slabs[obj.slab];
+    SizeClass &sc = classes[slab.sizeClass];
+
+    slab.bitmap[obj.slot / 64] &= ~(1ULL << (obj.slot % 64));
+
+    if (slab.used == slab.capacity)
+        move_slab(sc.full, sc.partial, obj.slab);
+
+    slab.used--;
+    sc.liveObjects--;
+    sc.requestedBytes -= obj.requested;
+
+    if (slab.used == 0) {
+        move_slab(sc.partial, sc.empty, obj.slab);
+
+        if (sc.empty.size() > MAX_EMPTY_SLABS) {
+            int victim = sc.empty.front();
+            sc.empty.erase(sc.empty.begin());
+            release_slab(victim);
+        }
+    }
+
+    SIM_LOG << "[SLAB] Block " << id << " released\n";
+}
+
+// Address of a live object, SIZE_MAX if the id is unknown
+size_t slab_block_address(int id) {
+    auto it = objects.find(id);
+    if (it == objects.end())
+        return SIZE_MAX;
+
+    const Slab &slab = slabs[it->second.slab];
+    return slab.base + it->second.slot * classes[slab.sizeClass].objSize;
+}
+
+/* ================= REALLOC ================= */
+
+// Stays in the slot while the size class is unchanged; otherwise the
+// object moves to a slot of the new class under the same id. The
+// original alignment picks the class either way.
+int slab_realloc(int id, size_t newSize) {
+    auto it = objects.find(id);
+    if (it == objects.end()) {
+        SIM_LOG << "[SLAB] Invalid block id\n";
+        return -1;
+    }
+
+    int cls = slabs[it->second.slab].sizeClass;
+    int target = class_for(newSize, it->second.align);
+
+    if (target == cls) {
+        classes[cls].requestedBytes += newSize;
+        classes[cls].requestedBytes -= it->second.requested;
+        it->second.requested = newSize;
+        realloc_in_place++;
+        SIM_LOG << "[SLAB] Block " << id << " resized in place\n";
+        return id;
+    }
+
+    size_t oldRequested = it->second.requested;
+    SlabObject moved;
+    if (target == -1 || !take_object(target, newSize, it->second.align, moved)) {
+        SIM_LOG << "[SLAB] Block " << id << " unchanged (no space)\n";
+        return -1;
+    }
+
+    slab_free(id);
+    objects[id] = moved;
+
+    realloc_moved++;
+    realloc_copy_bytes += min(oldRequested, newSize);
+    SIM_LOG << "[SLAB] Block " << id << " moved, copied "
+            << min(oldRequested, newSize) << " units\n";
+    return id;
+}
+
+/* ================= CHECKPOINT ================= */
+
+// Slab pages live in the buddy engine: restore buddy first, from the
+// same snapshot, or the slabs point at blocks buddy considers free.
+struct SlabCheckpoint {
+    uint64_t slabSize;
+    int64_t nextId, successCount, failureCount;
+    int64_t reallocInPlace, reallocMoved;
+    uint64_t reallocCopyBytes;
+    uint64_t classCount, slabCount;
+};
+
+struct SlabClassRecord {
+    uint64_t objSize, liveObjects, requestedBytes;
+};
+
+struct SlabRecord {
+    uint64_t base, capacity, used;
+    int64_t sizeClass;
+    uint8_t live;
+};
+
+struct SlabObjectRecord {
+    int64_t id, slab;
+    uint64_t slot, requested, align;
+};
+
+void slab_checkpoint(SnapshotWriter &w) {
+    SlabCheckpoint c = {
+        SLAB_SIZE, NEXT_ID, success_count, failure_count,
+        realloc_in_place, realloc_moved, realloc_copy_bytes,
+        classes.size(), slabs.size()
+    };
+
+    vector<SlabObjectRecord> objs;
+    for (auto &o : objects)
+        objs.push_back({o.first, o.second.slab, o.second.slot, o.second.requested,
+                        o.second.align});
+    sort(objs.begin(), objs.end(), [](const SlabObjectRecord &x, const SlabObjectRecord &y) {
+        return x.id < y.id;
+    });
+
+    w.section(SEC_SLAB);
+    w.put(c);
+
+    for (auto &sc : classes) {
+        w.put(SlabClassRecord{sc.objSize, sc.liveObjects, sc.requestedBytes});
+        w.putVector(sc.partial);
+        w.putVector(sc.full);
+        w.putVector(sc.empty);
+    }
+
+    for (auto &slab : slabs) {
+        w.put(SlabRecord{slab.base, slab.capacity, slab.used, slab.sizeClass, slab.live});
+        w.putVector(slab.bitmap);
+    }
+
+    w.putVector(deadSlabs);
+    w.putVector(objs);
+}
+
+// Restore is staged: the section is parsed and checked into
+// `staged` first, and the engine only changes on commit.
+struct SlabImage {
+    SlabCheckpoint c;
+    vector<SizeClass> classes;
+    vector<Slab> slabs;
+    vector<int> dead;
+    vector<SlabObjectRecord> objects;
+};
+
+static SlabImage staged;
+
+static bool power_of_two(size_t v) {
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+static bool slot_taken(const Slab &slab, size_t slot) {
+    return (slab.bitmap[slot / 64] >> (slot % 64)) & 1;
+}
+
+// Every index is range-checked; each live slab sits on exactly one
+// list of its own class, and the objects match the slab bitmaps.
+static bool slab_valid(const SlabImage &img) {
+    const SlabCheckpoint &c = img.c;
+    size_t nSlabs = img.slabs.size();
+
+    if (!power_of_two(c.slabSize) || c.nextId < 1)
+        return false;
+
+    for (size_t i = 0; i < img.classes.size(); i++) {
+        size_t objSize = img.classes[i].objSize;
+        if (objSize == 0 || objSize > c.slabSize
+            || (i > 0 && img.classes[i - 1].objSize >= objSize))
+            return false;
+    }
+
+    for (auto &slab : img.slabs) {
+        if (!slab.live) {
+            if (!slab.bitmap.empty())
+                return false;
+            continue;
+        }
+
+        if (slab.sizeClass < 0 || (size_t)slab.sizeClass >= img.classes.size()
+            || slab.base % c.slabSize != 0
+            || slab.capacity != c.slabSize / img.classes[slab.sizeClass].objSize
+            || slab.bitmap.size() != (slab.capacity + 63) / 64
+            || slab.used > slab.capacity)
+            return false;
+
+        size_t taken = 0;
+        for (uint64_t word : slab.bitmap)
+            taken += __builtin_popcountll(word);
+        if (taken != slab.used + slab.bitmap.size() * 64 - slab.capacity)
+            return false;
+    }
+
+    vector<int> listed(nSlabs, 0);
+    for (size_t i = 0; i < img.classes.size(); i++) {
+        const SizeClass &sc = img.classes[i];
+        for (const vector<int> *list : {&sc.partial, &sc.full, &sc.empty}) {
+            for (int s : *list) {
+                if (s < 0 || (size_t)s >= nSlabs || !img.slabs[s].live
+                    || (size_t)img.slabs[s].sizeClass != i || listed[s]++)
+                    return false;
+                if ((list == &sc.full && img.slabs[s].used != img.slabs[s].capacity)
+                    || (list == &sc.empty && img.slabs[s].used != 0))
+                    return false;
+            }
+        }
+    }
+
+    for (size_t s = 0; s < nSlabs; s++) {
+        if (img.slabs[s].live && !listed[s])
+            return false;
+    }
+
+    for (int s : img.dead) {
+        if (s < 0 || (size_t)s >= nSlabs || img.slabs[s].live || listed[s]++)
+            return false;
+    }
+
+    vector<size_t> perSlab(nSlabs, 0);
+    vector<size_t> liveObjects(img.classes.size(), 0), requested(img.classes.size(), 0);
+    vector<pair<int64_t, uint64_t>> slots;
+
+    for (size_t i = 0; i < img.objects.size(); i++) {
+        const SlabObjectRecord &o = img.objects[i];
+        if (o.id < 1 || o.id >= c.nextId || (i > 0 && img.objects[i - 1].id >= o.id)
+            || o.slab < 0 || (uint64_t)o.slab >= nSlabs || !img.slabs[o.slab].live)
+            return false;
+
+        const Slab &slab = img.slabs[o.slab];
+        const SizeClass &sc = img.classes[slab.sizeClass];
+        if (o.slot >= slab.capacity || !slot_taken(slab, o.slot)
+            || o.requested > sc.objSize || !power_of_two(o.align))
+            return false;
+
+        perSlab[o.slab]++;
+        liveObjects[slab.sizeClass]++;
+        requested[slab.sizeClass] += o.requested;
+        slots.push_back({o.slab, o.slot});
+    }
+
+    sort(slots.begin(), slots.end());
+    if (adjacent_find(slots.begin(), slots.end()) != slots.end())
+        return false;
+
+    for (size_t s = 0; s < nSlabs; s++) {
+        if (img.slabs[s].live && perSlab[s] != img.slabs[s].used)
+            return false;
+    }
+
+    for (size_t i = 0; i < img.classes.size(); i++) {
+        if (img.classes[i].liveObjects != liveObjects[i]
+            || img.classes[i].requestedBytes != requested[i])
+            return false;
+    }
+    return true;
+}
+
+bool slab_restore_stage(const SnapshotReader &r) {
+    SectionCursor cur;
+    SlabCheckpoint &c = staged.c;
+
+    if (!r.section(SEC_SLAB, cur) || !cur.get(c))
+        return false;
+
+    // every record takes at least its own size, so a count larger than
+    // the rest of the section is damage, not a huge heap
+    if (c.classCount > cur.remaining() / sizeof(SlabClassRecord))
+        return false;
+
+    staged.classes.clear();
+    for (uint64_t i = 0; i < c.classCount && cur.ok(); i++) {
+        SlabClassRecord rec = {};
+        cur.get(rec);
+        staged.classes.emplace_back(rec.objSize);
+        staged.classes.back().liveObjects = rec.liveObjects;
+        staged.classes.back().requestedBytes = rec.requestedBytes;
+        cur.getVector(staged.classes.back().partial);
+        cur.getVector(staged.classes.back().full);
+        cur.getVector(staged.classes.back().empty);
+    }
+
+    if (!cur.ok() || c.slabCount > cur.remaining() / sizeof(SlabRecord))
+        return false;
+
+    staged.slabs.assign(c.slabCount, Slab());
+    for (auto &slab : staged.slabs) {
+        SlabRecord rec = {};
+        cur.get(rec);
+        slab.base = rec.base;
+        slab.capacity = rec.capacity;
+        slab.used = rec.used;
+        slab.sizeClass = rec.sizeClass;
+        slab.live = rec.live;
+        cur.getVector(slab.bitmap);
+    }
+
+    cur.getVector(staged.dead);
+    cur.getVector(staged.objects);
+
+    return cur.ok() && slab_valid(staged);
+}
+
+// Only after slab_restore_stage() succeeded
+void slab_restore_commit() {
+    const SlabCheckpoint &c = staged.c;
+
+    classes.swap(staged.classes);
+    slabs.swap(staged.slabs);
+    deadSlabs.swap(staged.dead);
+
+    objects.clear();
+    objects.reserve(staged.objects.size());
+    for (auto &o : staged.objects)
+        objects[o.id] = {(int)o.slab, o.slot, o.requested, o.align};
+
+    staged.classes.clear();
+    staged.slabs.clear();
+    staged.dead.clear();
+    staged.objects.clear();
+
+    CLASS_SIZES.clear();
+    for (auto &sc : classes)
+        CLASS_SIZES.push_back(sc.objSize);
+
+    SLAB_SIZE = c.slabSize;
+    NEXT_ID = c.nextId;
+    success_count = c.successCount;
+    failure_count = c.failureCount;
+    realloc_in_place = c.reallocInPlace;
+    realloc_moved = c.reallocMoved;
+    realloc_copy_bytes = c.reallocCopyBytes;
+}
+
+/* ================= DEBUG VIEW ================= */
+
+void slab_dump() {
+    cout << "\n--- Slab Layout ---\n";
+
+    for (auto &sc : classes) {
+        cout << "Class " << sc.objSize
+             << ": partial=" << sc.partial.size()
+             << " full=" << sc.full.size()
+             << " empty=" << sc.empty.size() << "\n";
+
+        auto show = [&](const vector<int> &list, const char *tag) {
+            for (int s : list) {
+                const Slab &slab = slabs[s];
+                cout << "  [" << tag << "] slab @" << slab.base
+                     << " used " << slab.used << "/" << slab.capacity << "\n";
+            }
+        };
+
+        show(sc.partial, "PARTIAL");
+        show(sc.full, "FULL");
+        show(sc.empty, "EMPTY");
+    }
+}
+
+/* ================= STATS ================= */
+
+// Free slots only serve their own class, so the largest allocatable
+// region is the biggest class that still has a free slot.
+FragSample slab_frag_sample() {
+    FragSample s = {0, 0, 0, 0, 0};
+
+    for (auto &sc : classes) {
+        size_t count = sc.partial.size() + sc.full.size() + sc.empty.size();
+        size_t freeSlots = count * (SLAB_SIZE / sc.objSize) - sc.liveObjects;
+
+        s.total += count * SLAB_SIZE;
+        s.used += sc.liveObjects * sc.objSize;
+        s.requested += sc.requestedBytes;
+        s.freeBytes += freeSlots * sc.objSize;
+        if (freeSlots > 0)
+            s.largestFree = max(s.largestFree, sc.objSize);
+    }
+
+    return s;
+}
+
+void slab_stats() {
+    size_t totalReserved = 0;
+    size_t totalRequested = 0;
+    size_t totalTail = 0;
+    size_t slabCount = 0;
+
+    cout << "\n--- Slab Statistics ---\n";
+    cout << "Slab Size: " << SLAB_SIZE << "\n";
+
+    for (auto &sc : classes) {
+        size_t count = sc.partial.size() + sc.full.size() + sc.empty.size();
+        size_t capacity = SLAB_SIZE / sc.objSize;
+        size_t reserved = sc.liveObjects * sc.objSize;
+        size_t tail = count * (SLAB_SIZE - capacity * sc.objSize);
+
+        double internal = reserved
+            ? (double)(reserved - sc.requestedBytes) / reserved : 0.0;
+
+        cout << "Class " << sc.objSize
+             << " | slabs " << count
+             << " | live " << sc.liveObjects
+             << " | requested " << sc.requestedBytes
+             << " | reserved " << reserved
+             << " | internal frag " << internal * 100 << "%\n";
+
+        totalReserved += reserved;
+        totalRequested += sc.requestedBytes;
+        totalTail += tail;
+        slabCount += count;
+    }
+
+    double internal = totalReserved
+        ? (double)(totalReserved - totalRequested) / totalReserved : 0.0;
+
+    cout << "Slabs In Use: " << slabCount
+         << " (" << slabCount * SLAB_SIZE << " units from buddy)\n";
+    cout << "Slab Tail Waste: " << totalTail << "\n";
+    cout << "Internal Fragmentation: " << internal * 100 << "%\n";
+    cout << "Alloc Success: " << success_count << "\n";
+    cout << "Alloc Failure: " << failure_count << "\n";
+    cout << "Realloc In-Place: " << realloc_in_place << "\n";
+    cout << "Realloc Moved   : " << realloc_moved
+         << " (" << realloc_copy_bytes << " units copied)\n";
+}
@@ -0,0 +1,141 @@
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../../include/snapshot.h"
+
+using namespace std;
+
+/* ================= WRITER ================= */
+
+// fsync a file or directory by name
+static bool sync_path(const string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool ok = fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+bool SnapshotWriter::save(const string &path) const {
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.sections = sections.size();
+
+    vector<SectionEntry> table(sections.size());
+    uint64_t offset = snapshot_pad(sizeof(SnapshotHeader) + table.size() * sizeof(SectionEntry));
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        table[i].kind = sections[i].first;
+        table[i].reserved = 0;
+        table[i].offset = offset;
+        table[i].size = sections[i].second.size();
+        offset += table[i].size;
+    }
+    header.fileSize = offset;
+
+    // Written under a temporary name and synced before the rename, and
+    // the directory is synced after it: a crash leaves either the old
+    // snapshot or the complete new one, never a torn file.
+    string tmp = path + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(table.data()),
+                  table.size() * sizeof(SectionEntry));
+
+        static const char zeros[8] = {0};
+        size_t used = sizeof(header) + table.size() * sizeof(SectionEntry);
+        out.write(zeros, snapshot_pad(used) - used);
+
+        for (auto &s : sections)
+            out.write(s.second.data(), s.second.size());
+
+        out.close();
+        if (!out)
+            return false;
+    }
+
+    if (!sync_path(tmp) || rename(tmp.c_str(), path.c_str()) != 0)
+        return false;
+
+    size_t slash = path.find_last_of('/');
+    return sync_path(slash == string::npos ? "." : path.substr(0, slash + 1));
+}
+
+/* ================= READER ================= */
+
+bool SnapshotReader::open(const string &path) {
+    close();
+    error.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        error = path + " is too small to be a snapshot";
+        return false;
+    }
+
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+
+    base = static_cast<const char *>(map);
+    size = st.st_size;
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(base);
+    size_t tableEnd = sizeof(SnapshotHeader) + (size_t)header->sections * sizeof(SectionEntry);
+
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0)
+        error = path + " is not a memsim snapshot";
+    else if (header->version != SNAPSHOT_VERSION)
+        error = path + " has format version " + to_string(header->version)
+              + ", expected " + to_string(SNAPSHOT_VERSION);
+    else if (header->fileSize != size || tableEnd > size)
+        error = path + " is truncated";
+    else
+        return true;
+
+    close();
+    return false;
+}
+
+void SnapshotReader::close() {
+    if (base)
+        munmap(const_cast<char *>(base), size);
+    base = nullptr;
+    size = 0;
+}
+
+bool SnapshotReader::section(SnapshotSection kind, SectionCursor &cursor) const {
+    if (!base)
+        return false;
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(base);
+    const SectionEntry *table = reinterpret_cast<const SectionEntry *>(base + sizeof(SnapshotHeader));
+
+    for (uint32_t i = 0; i < header->sections; i++) {
+        if (table[i].kind == kind) {
+            if (table[i].offset > size || table[i].size > size - table[i].offset)
+                return false;
+            cursor = SectionCursor(base + table[i].offset, table[i].size);
+            return true;
+        }
+    }
+    return false;
+}
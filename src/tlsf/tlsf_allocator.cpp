@@ -0,0 +1,701 @@
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "../../include/fragmentation.h"
+#include "../../include/sim_log.h"
+#include "../../include/snapshot.h"
+
+using namespace std;
+
+/*
+ TWO-LEVEL SEGREGATED FIT (TLSF) ALLOCATOR
+ -----------------------------------------
+ - First level splits sizes by power of two, second level splits
+   each power-of-two range into SL_COUNT linear bins
+ - One bitmap per level: finding a bin is two bit scans, O(1)
+ - Boundary tags (physical prev/next links) give O(1) coalescing
+ - Worst-case and mean latency tracked per operation
+*/
+
+/* ================= CONFIGURATION ================= */
+
+static const int SL_LOG2 = 4;
+static const int SL_COUNT = 1 << SL_LOG2;
+static const int ALIGN_LOG2 = 3;
+static const size_t ALIGN_SIZE = 1 << ALIGN_LOG2;
+static const int FL_SHIFT = SL_LOG2 + ALIGN_LOG2;
+static const size_t SMALL_BLOCK = 1 << FL_SHIFT;
+static const int FL_MAX = 40;
+static const int FL_COUNT = FL_MAX - FL_SHIFT + 1;
+static const size_t MIN_BLOCK_SIZE = 16;
+
+/* ================= TLSF STATE ================= */
+
+struct TlsfBlock {
+    size_t start;
+    size_t size;
+    bool free;
+    int prevPhys, nextPhys;   // boundary tags
+    int prevFree, nextFree;   // segregated free list links
+    int id;
+    size_t payload;
+    size_t requested;
+    size_t align;             // alignment the block was placed with
+};
+
+static vector<TlsfBlock> nodes;
+static vector<int> spareNodes;
+static unordered_map<int, int> idToNode;
+
+static uint64_t flBitmap = 0;
+static uint32_t slBitmap[FL_COUNT];
+static int heads[FL_COUNT][SL_COUNT];
+
+static size_t TOTAL_SIZE = 0;
+static size_t HEADER_SIZE = 0;
+static int NEXT_ID = 1;
+
+static int success_count = 0;
+static int failure_count = 0;
+
+struct Latency {
+    size_t count;
+    uint64_t totalNs;
+    uint64_t worstNs;
+};
+
+static Latency mallocLatency = {0, 0, 0};
+static Latency freeLatency = {0, 0, 0};
+static Latency reallocLatency = {0, 0, 0};
+
+static int realloc_in_place = 0;     // shrink, or growth into slack
+static int realloc_merged = 0;       // grown by absorbing the free successor
+static int realloc_moved = 0;
+static size_t realloc_copy_bytes = 0;
+
+/* ================= INTERNAL HELPERS ================= */
+
+static inline int fls_size(size_t v) {
+    return 63 - __builtin_clzll(v);
+}
+
+static inline size_t round_up(size_t v, size_t a) {
+    return (v + a - 1) / a * a;
+}
+
+// size -> (fl, sl) bin holding blocks of that size
+static void mapping_insert(size_t size, int &fl, int &sl) {
+    if (size < SMALL_BLOCK) {
+        fl = 0;
+        sl = size / (SMALL_BLOCK / SL_COUNT);
+    } else {
+        int f = fls_size(size);
+        sl = (int)(size >> (f - SL_LOG2)) ^ SL_COUNT;
+        fl = f - (FL_SHIFT - 1);
+    }
+}
+
+// rounds up so every block in the resulting bin is large enough
+static void mapping_search(size_t size, int &fl, int &sl) {
+    if (size >= SMALL_BLOCK)
+        size += ((size_t)1 << (fls_size(size) - SL_LOG2)) - 1;
+    mapping_insert(size, fl, sl);
+}
+
+static int search_suitable(int &fl, int &sl) {
+    if (fl >= FL_COUNT)
+        return -1;
+
+    uint32_t slMap = slBitmap[fl] & (~0U << sl);
+    if (!slMap) {
+        uint64_t flMap = fl + 1 < 64 ? flBitmap & (~0ULL << (fl + 1)) : 0;
+        if (!flMap)
+            return -1;
+
+        fl = __builtin_ctzll(flMap);
+        slMap = slBitmap[fl];
+    }
+
+    sl = __builtin_ctz(slMap);
+    return heads[fl][sl];
+}
+
+static void insert_free(int n) {
+    int fl, sl;
+    mapping_insert(nodes[n].size, fl, sl);
+
+    TlsfBlock &b = nodes[n];
+    b.free = true;
+    b.prevFree = -1;
+    b.nextFree = heads[fl][sl];
+    if (b.nextFree != -1)
+        nodes[b.nextFree].prevFree = n;
+    heads[fl][sl] = n;
+
+    flBitmap |= 1ULL << fl;
+    slBitmap[fl] |= 1U << sl;
+}
+
+static void remove_free(int n) {
+    int fl, sl;
+    mapping_insert(nodes[n].size, fl, sl);
+
+    TlsfBlock &b = nodes[n];
+    if (b.prevFree != -1)
+        nodes[b.prevFree].nextFree = b.nextFree;
+    else
+        heads[fl][sl] = b.nextFree;
+    if (b.nextFree != -1)
+        nodes[b.nextFree].prevFree = b.prevFree;
+
+    if (heads[fl][sl] == -1) {
+        slBitmap[fl] &= ~(1U << sl);
+        if (!slBitmap[fl])
+            flBitmap &= ~(1ULL << fl);
+    }
+
+    b.free = false;
+}
+
+static int new_node(size_t start, size_t size) {
+    int n;
+    if (!spareNodes.empty()) {
+        n = spareNodes.back();
+        spareNodes.pop_back();
+    } else {
+        n = nodes.size();
+        nodes.emplace_back();
+    }
+
+    nodes[n] = {start, size, false, -1, -1, -1, -1, -1, start, 0, ALIGN_SIZE};
+    return n;
+}
+
+// cuts `size` bytes off the front of n; the rest becomes a new node
+static int split(int n, size_t size) {
+    int rest = new_node(nodes[n].start + size, nodes[n].size - size);
+    nodes[n].size = size;
+
+    nodes[rest].prevPhys = n;
+    nodes[rest].nextPhys = nodes[n].nextPhys;
+    if (nodes[n].nextPhys != -1)
+        nodes[nodes[n].nextPhys].prevPhys = rest;
+    nodes[n].nextPhys = rest;
+    return rest;
+}
+
+// absorbs physical successor `next` into n
+static void absorb(int n, int next) {
+    nodes[n].size += nodes[next].size;
+    nodes[n].nextPhys = nodes[next].nextPhys;
+    if (nodes[next].nextPhys != -1)
+        nodes[nodes[next].nextPhys].prevPhys = n;
+    spareNodes.push_back(next);
+}
+
+// coalesces a newly freed block with free neighbours, then bins it
+static void release(int n) {
+    int next = nodes[n].nextPhys;
+    if (next != -1 && nodes[next].free) {
+        remove_free(next);
+        absorb(n, next);
+    }
+
+    int prev = nodes[n].prevPhys;
+    if (prev != -1 && nodes[prev].free) {
+        remove_free(prev);
+        absorb(prev, n);
+        n = prev;
+    }
+
+    insert_free(n);
+}
+
+static size_t used_size(size_t request) {
+    size_t header = round_up(HEADER_SIZE, ALIGN_SIZE);
+    return max(round_up(header + request, ALIGN_SIZE), MIN_BLOCK_SIZE);
+}
+
+static void record(Latency &lat, chrono::steady_clock::time_point begin) {
+    uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - begin).count();
+    lat.count++;
+    lat.totalNs += ns;
+    lat.worstNs = max(lat.worstNs, ns);
+}
+
+// O(1) placement: bit scans, an optional leading trim for alignment
+// and a trailing split. Returns the node or -1.
+static int place(size_t request, size_t align) {
+    align = max(align, ALIGN_SIZE);
+    size_t header = round_up(HEADER_SIZE, ALIGN_SIZE);
+    size_t need = used_size(request);
+    size_t search = need + (align > ALIGN_SIZE ? align + MIN_BLOCK_SIZE : 0);
+
+    int fl, sl;
+    mapping_search(search, fl, sl);
+    int n = search_suitable(fl, sl);
+    if (n == -1)
+        return -1;
+
+    remove_free(n);
+
+    size_t payload = round_up(nodes[n].start + header, align);
+    size_t gap = payload - header - nodes[n].start;
+
+    if (gap > 0 && gap < MIN_BLOCK_SIZE) {
+        payload = round_up(nodes[n].start + MIN_BLOCK_SIZE + header, align);
+        gap = payload - header - nodes[n].start;
+    }
+
+    if (gap > 0) {
+        int lead = n;
+        n = split(lead, gap);
+        insert_free(lead);
+    }
+
+    if (nodes[n].size - need >= MIN_BLOCK_SIZE) {
+        int rest = split(n, need);
+        insert_free(rest);
+    }
+
+    nodes[n].payload = payload;
+    nodes[n].requested = request;
+    nodes[n].align = align;
+    return n;
+}
+
+/* ================= PUBLIC API ================= */
+
+void tlsf_init(size_t memorySize) {
+    nodes.clear();
+    spareNodes.clear();
+    idToNode.clear();
+    flBitmap = 0;
+
+    for (int fl = 0; fl < FL_COUNT; fl++) {
+        slBitmap[fl] = 0;
+        for (int sl = 0; sl < SL_COUNT; sl++)
+            heads[fl][sl] = -1;
+    }
+
+    TOTAL_SIZE = memorySize / ALIGN_SIZE * ALIGN_SIZE;
+    if (TOTAL_SIZE >= ((size_t)1 << FL_MAX))
+        TOTAL_SIZE = ((size_t)1 << FL_MAX) - ALIGN_SIZE;
+
+    NEXT_ID = 1;
+    success_count = 0;
+    failure_count = 0;
+    mallocLatency = {0, 0, 0};
+    freeLatency = {0, 0, 0};
+    reallocLatency = {0, 0, 0};
+    realloc_in_place = 0;
+    realloc_merged = 0;
+    realloc_moved = 0;
+    realloc_copy_bytes = 0;
+
+    if (TOTAL_SIZE >= MIN_BLOCK_SIZE)
+        insert_free(new_node(0, TOTAL_SIZE));
+
+    SIM_LOG << "[TLSF INIT] Memory size = " << TOTAL_SIZE << "\n";
+}
+
+void tlsf_set_header(size_t header) {
+    HEADER_SIZE = header;
+}
+
+int tlsf_malloc(size_t request, size_t align) {
+    auto begin = chrono::steady_clock::now();
+    int n = place(request, align);
+    record(mallocLatency, begin);
+
+    if (n == -1) {
+        failure_count++;
+        SIM_LOG << "[TLSF] Allocation failed\n";
+        return -1;
+    }
+
+    int id = NEXT_ID++;
+    nodes[n].id = id;
+    idToNode[id] = n;
+    success_count++;
+
+    SIM_LOG << "[TLSF] Allocated block " << id << " at " << nodes[n].start
+            << " (size " << nodes[n].size << ")\n";
+    return id;
+}
+
+void tlsf_free(int id) {
+    auto it = idToNode.find(id);
+    if (it == idToNode.end()) {
+        SIM_LOG << "[TLSF] Invalid block id\n";
+        return;
+    }
+
+    int n = it->second;
+    idToNode.erase(it);
+
+    auto begin = chrono::steady_clock::now();
+    nodes[n].id = -1;
+    nodes[n].requested = 0;
+    release(n);
+    record(freeLatency, begin);
+
+    SIM_LOG << "[TLSF] Block " << id << " released\n";
+}
+
+// Payload address of a live block, SIZE_MAX if the id is unknown
+size_t tlsf_block_address(int id) {
+    auto it = idToNode.find(id);
+    return it == idToNode.end() ? SIZE_MAX : nodes[it->second].payload;
+}
+
+// In place when the block (plus a free successor) is big enough,
+// otherwise allocate-copy-free under the same id, keeping the block's
+// alignment.
+int tlsf_realloc(int id, size_t newSize) {
+    auto it = idToNode.find(id);
+    if (it == idToNode.end()) {
+        SIM_LOG << "[TLSF] Invalid block id\n";
+        return -1;
+    }
+
+    int n = it->second;
+    auto begin = chrono::steady_clock::now();
+    size_t need = max(round_up(nodes[n].payload - nodes[n].start + newSize,
+                               ALIGN_SIZE), MIN_BLOCK_SIZE);
+
+    bool merged = false;
+    int next = nodes[n].nextPhys;
+    if (need > nodes[n].size && next != -1 && nodes[next].free
+        && nodes[n].size + nodes[next].size >= need) {
+        remove_free(next);
+        absorb(n, next);
+        merged = true;
+    }
+
+    if (need <= nodes[n].size) {
+        if (nodes[n].size - need >= MIN_BLOCK_SIZE)
+            release(split(n, need));
+
+        nodes[n].requested = newSize;
+        record(reallocLatency, begin);
+        if (merged)
+            realloc_merged++;
+        else
+            realloc_in_place++;
+        SIM_LOG << "[TLSF] Block " << id << (merged ? " merged" : " resized")
+                << " in place\n";
+        return id;
+    }
+
+    size_t oldRequested = nodes[n].requested;
+    int moved = place(newSize, nodes[n].align);
+    if (moved == -1) {
+        record(reallocLatency, begin);
+        SIM_LOG << "[TLSF] Block " << id << " unchanged (no space)\n";
+        return -1;
+    }
+
+    nodes[moved].id = id;
+    idToNode[id] = moved;
+    nodes[n].id = -1;
+    nodes[n].requested = 0;
+    release(n);
+    record(reallocLatency, begin);
+
+    realloc_moved++;
+    realloc_copy_bytes += min(oldRequested, newSize);
+    SIM_LOG << "[TLSF] Block " << id << " moved to " << nodes[moved].start
+            << ", copied " << min(oldRequested, newSize) << " units\n";
+    return id;
+}
+
+/* ================= CHECKPOINT ================= */
+
+struct TlsfCheckpoint {
+    uint64_t totalSize;
+    int64_t nextId, successCount, failureCount;
+    uint64_t flBitmap;
+    Latency mallocLatency, freeLatency, reallocLatency;
+    int64_t reallocInPlace, reallocMerged, reallocMoved;
+    uint64_t reallocCopyBytes;
+};
+
+struct TlsfIdRecord {
+    int64_t id, node;
+};
+
+// Nodes are written as-is: list links are node indices, so the
+// free lists and boundary tags come back without rebuilding.
+void tlsf_checkpoint(SnapshotWriter &w) {
+    TlsfCheckpoint c = {
+        TOTAL_SIZE, NEXT_ID, success_count, failure_count,
+        flBitmap, mallocLatency, freeLatency, reallocLatency,
+        realloc_in_place, realloc_merged, realloc_moved, realloc_copy_bytes
+    };
+
+    vector<TlsfIdRecord> ids;
+    for (auto &h : idToNode)
+        ids.push_back({h.first, h.second});
+    sort(ids.begin(), ids.end(), [](const TlsfIdRecord &x, const TlsfIdRecord &y) {
+        return x.id < y.id;
+    });
+
+    w.section(SEC_TLSF);
+    w.put(c);
+    w.putArray(slBitmap, FL_COUNT);
+    w.putArray(&heads[0][0], FL_COUNT * SL_COUNT);
+    w.putVector(nodes);
+    w.putVector(spareNodes);
+    w.putVector(ids);
+}
+
+// Restore is staged: the section is parsed and checked into
+// `staged` first, and the engine only changes on commit.
+struct TlsfImage {
+    TlsfCheckpoint c;
+    vector<uint32_t> sl;
+    vector<int> heads;
+    vector<TlsfBlock> nodes;
+    vector<int> spare;
+    vector<TlsfIdRecord> ids;
+};
+
+static TlsfImage staged;
+
+// Every link is range-checked; live nodes must form one physical
+// chain of non-empty blocks tiling [0, totalSize), boundary tags must
+// agree both ways, the bitmaps must match the bin heads, and each free
+// list must be a chain of free nodes sitting in the bin of their size.
+static bool tlsf_valid(const TlsfImage &img) {
+    const TlsfCheckpoint &c = img.c;
+    int n = img.nodes.size();
+    auto inRange = [n](int64_t i) { return i >= -1 && i < n; };
+
+    if (c.totalSize >= ((size_t)1 << FL_MAX) || c.nextId < 1
+        || (c.flBitmap >> FL_COUNT) != 0)
+        return false;
+
+    // spare nodes keep stale links; only live nodes are checked
+    vector<char> spare(n, 0);
+    for (int s : img.spare) {
+        if (s < 0 || s >= n || spare[s]++)
+            return false;
+    }
+
+    for (int i = 0; i < n; i++) {
+        const TlsfBlock &b = img.nodes[i];
+        if (spare[i])
+            continue;
+
+        if (!inRange(b.prevPhys) || !inRange(b.nextPhys) || !inRange(b.prevFree)
+            || !inRange(b.nextFree) || b.size == 0 || b.start > c.totalSize
+            || b.size > c.totalSize - b.start)
+            return false;
+
+        int next = b.nextPhys;
+        if (next != -1 && (spare[next] || img.nodes[next].prevPhys != i
+                           || img.nodes[next].start != b.start + b.size))
+            return false;
+    }
+
+    // the chain starts at offset 0; since starts strictly increase it
+    // cannot cycle, and it must reach every live node
+    int live = n - img.spare.size(), first = -1, walked = 0;
+    for (int i = 0; i < n && first == -1; i++) {
+        if (!spare[i] && img.nodes[i].prevPhys == -1)
+            first = i;
+    }
+
+    size_t covered = 0;
+    for (int at = first; at != -1 && walked <= live; at = img.nodes[at].nextPhys) {
+        if (img.nodes[at].start != covered)
+            return false;
+        covered += img.nodes[at].size;
+        walked++;
+    }
+
+    if (live == 0 ? c.totalSize >= MIN_BLOCK_SIZE
+                  : walked != live || covered != c.totalSize)
+        return false;
+
+    vector<char> binned(n, 0);
+    for (int fl = 0; fl < FL_COUNT; fl++) {
+        if (((c.flBitmap >> fl) & 1) != (img.sl[fl] != 0))
+            return false;
+
+        for (int sl = 0; sl < SL_COUNT; sl++) {
+            int head = img.heads[fl * SL_COUNT + sl];
+            if (!inRange(head) || ((img.sl[fl] >> sl) & 1) != (head != -1))
+                return false;
+
+            for (int at = head, prev = -1; at != -1; prev = at, at = img.nodes[at].nextFree) {
+                int f, s;
+                if (spare[at] || !img.nodes[at].free || img.nodes[at].prevFree != prev
+                    || binned[at]++)
+                    return false;
+
+                mapping_insert(img.nodes[at].size, f, s);
+                if (f != fl || s != sl)
+                    return false;
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (!spare[i] && img.nodes[i].free && !binned[i])
+            return false;
+    }
+
+    for (size_t i = 0; i < img.ids.size(); i++) {
+        const TlsfIdRecord &h = img.ids[i];
+        if (h.id < 1 || h.id >= c.nextId || (i > 0 && img.ids[i - 1].id >= h.id)
+            || h.node < 0 || h.node >= n || spare[h.node])
+            return false;
+
+        const TlsfBlock &b = img.nodes[h.node];
+        if (b.free || b.id != h.id || (b.align & (b.align - 1)) != 0
+            || b.payload < b.start || b.payload > b.start + b.size)
+            return false;
+    }
+    return true;
+}
+
+bool tlsf_restore_stage(const SnapshotReader &r) {
+    SectionCursor cur;
+
+    if (!r.section(SEC_TLSF, cur) || !cur.get(staged.c))
+        return false;
+
+    cur.getVector(staged.sl);
+    cur.getVector(staged.heads);
+    cur.getVector(staged.nodes);
+    cur.getVector(staged.spare);
+    cur.getVector(staged.ids);
+
+    // bin geometry is compiled in; a different build cannot restore
+    return cur.ok() && staged.sl.size() == (size_t)FL_COUNT
+        && staged.heads.size() == (size_t)FL_COUNT * SL_COUNT && tlsf_valid(staged);
+}
+
+// Only after tlsf_restore_stage() succeeded
+void tlsf_restore_commit() {
+    const TlsfCheckpoint &c = staged.c;
+
+    copy(staged.sl.begin(), staged.sl.end(), slBitmap);
+    copy(staged.heads.begin(), staged.heads.end(), &heads[0][0]);
+    nodes.swap(staged.nodes);
+    spareNodes.swap(staged.spare);
+
+    idToNode.clear();
+    idToNode.reserve(staged.ids.size());
+    for (auto &h : staged.ids)
+        idToNode[h.id] = h.node;
+
+    staged.nodes.clear();
+    staged.spare.clear();
+    staged.ids.clear();
+
+    TOTAL_SIZE = c.totalSize;
+    NEXT_ID = c.nextId;
+    success_count = c.successCount;
+    failure_count = c.failureCount;
+    flBitmap = c.flBitmap;
+    mallocLatency = c.mallocLatency;
+    freeLatency = c.freeLatency;
+    reallocLatency = c.reallocLatency;
+    realloc_in_place = c.reallocInPlace;
+    realloc_merged = c.reallocMerged;
+    realloc_moved = c.reallocMoved;
+    realloc_copy_bytes = c.reallocCopyBytes;
+}
+
+/* ================= DEBUG VIEW ================= */
+
+void tlsf_dump() {
+    cout << "\n--- TLSF Physical Blocks ---\n";
+
+    int n = nodes.empty() ? -1 : 0;
+    while (n != -1 && nodes[n].prevPhys != -1)
+        n = nodes[n].prevPhys;
+
+    for (; n != -1; n = nodes[n].nextPhys) {
+        const TlsfBlock &b = nodes[n];
+        cout << "[0x" << hex << b.start << " - 0x" << b.start + b.size - 1
+             << "] " << dec;
+        if (b.free)
+            cout << "FREE\n";
+        else
+            cout << "USED (id=" << b.id << ", req=" << b.requested << ")\n";
+    }
+
+    cout << "\n--- TLSF Bins (fl bitmap 0x" << hex << flBitmap << dec << ") ---\n";
+    for (int fl = 0; fl < FL_COUNT; fl++) {
+        if (!slBitmap[fl])
+            continue;
+        for (int sl = 0; sl < SL_COUNT; sl++) {
+            if (heads[fl][sl] == -1)
+                continue;
+            cout << "fl " << fl << " sl " << sl << ":";
+            for (int f = heads[fl][sl]; f != -1; f = nodes[f].nextFree)
+                cout << " " << nodes[f].start << "(" << nodes[f].size << ")";
+            cout << "\n";
+        }
+    }
+}
+
+/* ================= STATS ================= */
+
+FragSample tlsf_frag_sample() {
+    FragSample s = {TOTAL_SIZE, 0, 0, 0, 0};
+
+    for (auto &entry : idToNode) {
+        s.used += nodes[entry.second].size;
+        s.requested += nodes[entry.second].requested;
+    }
+
+    for (int fl = 0; fl < FL_COUNT; fl++) {
+        for (int sl = 0; sl < SL_COUNT; sl++) {
+            for (int f = heads[fl][sl]; f != -1; f = nodes[f].nextFree) {
+                s.freeBytes += nodes[f].size;
+                s.largestFree = max(s.largestFree, nodes[f].size);
+            }
+        }
+    }
+
+    return s;
+}
+
+void tlsf_stats() {
+    FragSample s = tlsf_frag_sample();
+
+    auto mean = [](const Latency &l) {
+        return l.count ? (double)l.totalNs / l.count : 0.0;
+    };
+
+    cout << "\n--- TLSF Statistics ---\n";
+    cout << "Total Memory: " << TOTAL_SIZE << "\n";
+    cout << "Used Memory : " << s.used << "\n";
+    cout << "Free Memory : " << s.freeBytes << "\n";
+    cout << "External Fragmentation: "
+         << external_fragmentation(s) * 100 << "%\n";
+    cout << "Internal Fragmentation: " << internal_fragmentation(s) * 100
+         << "% (" << s.used - s.requested << " units)\n";
+    cout << "Malloc Latency: mean " << mean(mallocLatency)
+         << " ns, worst " << mallocLatency.worstNs << " ns\n";
+    cout << "Free Latency  : mean " << mean(freeLatency)
+         << " ns, worst " << freeLatency.worstNs << " ns\n";
+    cout << "Realloc Latency: mean " << mean(reallocLatency)
+         << " ns, worst " << reallocLatency.worstNs << " ns\n";
+    cout << "Alloc Success: " << success_count << "\n";
+    cout << "Alloc Failure: " << failure_count << "\n";
+    cout << "Realloc In-Place: " << realloc_in_place << "\n";
+    cout << "Realloc Merged  : " << realloc_merged << "\n";
+    cout << "Realloc Moved   : " << realloc_moved
+         << " (" << realloc_copy_bytes << " units copied)\n";
+}
@@ -0,0 +1,255 @@
+#include <cmath>
+#include "../../include/workload.h"
+
+using namespace std;
+
+/* ================= ALLOCATION WORKLOADS ================= */
+
+AllocWorkload::AllocWorkload(const AllocSpec &s)
+    : spec(s), rng(s.seed), wheel(WHEEL_SLOTS), tick(0), nextSlot(0) {
+    if (spec.minSize == 0)
+        spec.minSize = 1;
+    if (spec.maxSize < spec.minSize)
+        spec.maxSize = spec.minSize;
+    if (spec.phaseLength == 0)
+        spec.phaseLength = 1;
+}
+
+static size_t uniform_size(Rng &rng, size_t lo, size_t hi) {
+    return lo + rng.below(hi - lo + 1);
+}
+
+static size_t power_law_size(Rng &rng, size_t lo, size_t hi, double alpha) {
+    double u = 1.0 - rng.uniform();   // (0, 1]
+    double size = lo / pow(u, 1.0 / alpha);
+    return size >= hi ? hi : (size_t)size;
+}
+
+static size_t bimodal_size(Rng &rng, size_t lo, size_t hi, double smallFraction) {
+    if (rng.uniform() < smallFraction)
+        return uniform_size(rng, lo, min(hi, lo * 4));
+    return uniform_size(rng, max(lo, hi / 4), hi);
+}
+
+size_t AllocWorkload::drawSize() {
+    switch (spec.dist) {
+        case SizeDist::POWER_LAW:
+            return power_law_size(rng, spec.minSize, spec.maxSize, spec.alpha);
+        case SizeDist::BIMODAL:
+            return bimodal_size(rng, spec.minSize, spec.maxSize, spec.smallFraction);
+        case SizeDist::PHASED:
+            break;
+    }
+
+    switch ((nextSlot / spec.phaseLength) % 3) {
+        case 0:
+            return power_law_size(rng, spec.minSize, spec.maxSize, spec.alpha);
+        case 1:
+            return bimodal_size(rng, spec.minSize, spec.maxSize, spec.smallFraction);
+        default:
+            return uniform_size(rng, max(spec.minSize, spec.maxSize / 4), spec.maxSize);
+    }
+}
+
+// 0 means the object is never freed
+size_t AllocWorkload::drawLifetime() {
+    double r = rng.uniform();
+    if (r < spec.immortalFraction)
+        return 0;
+
+    size_t life;
+    if (rng.uniform() < spec.shortFraction) {
+        // geometric, mean shortLifetime
+        life = 1 + (size_t)(-log(1.0 - rng.uniform()) * spec.shortLifetime);
+    } else {
+        life = spec.shortLifetime + rng.below(WHEEL_SLOTS);
+    }
+    return min(life, WHEEL_SLOTS - 1);
+}
+
+// Frees that are due at the current tick come first, then one malloc
+AllocEvent AllocWorkload::next() {
+    vector<uint32_t> &due = wheel[tick % WHEEL_SLOTS];
+    if (!due.empty()) {
+        uint32_t slot = due.back();
+        due.pop_back();
+        return {true, slot, 0};
+    }
+
+    tick++;
+    uint32_t slot = nextSlot;
+    size_t size = drawSize();
+    size_t life = drawLifetime();
+    nextSlot++;
+
+    if (life > 0)
+        wheel[(tick + life) % WHEEL_SLOTS].push_back(slot);
+
+    return {false, slot, size};
+}
+
+bool parse_size_dist(const string &name, SizeDist &dist) {
+    if (name == "powerlaw")
+        dist = SizeDist::POWER_LAW;
+    else if (name == "bimodal")
+        dist = SizeDist::BIMODAL;
+    else if (name == "phased")
+        dist = SizeDist::PHASED;
+    else
+        return false;
+    return true;
+}
+
+/* ================= ADDRESS STREAMS ================= */
+
+// Vose's alias method: O(n) build, O(1) sample. Threshold and alias
+// share a word so a draw is a single load.
+static void build_alias_table(const vector<double> &weights, vector<uint64_t> &table) {
+    size_t n = weights.size();
+    double sum = 0.0;
+    for (double w : weights)
+        sum += w;
+
+    vector<double> scaled(n);
+    vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; i++) {
+        scaled[i] = weights[i] * n / sum;
+        (scaled[i] < 1.0 ? small : large).push_back((uint32_t)i);
+    }
+
+    vector<uint32_t> prob(n, UINT32_MAX);
+    vector<uint32_t> alias(n);
+    for (size_t i = 0; i < n; i++)
+        alias[i] = (uint32_t)i;
+
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back(), l = large.back();
+        small.pop_back();
+
+        prob[s] = (uint32_t)(scaled[s] * 4294967295.0);
+        alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // leftovers are 1.0 up to rounding and keep prob = UINT32_MAX
+
+    table.resize(n);
+    for (size_t i = 0; i < n; i++)
+        table[i] = (uint64_t)alias[i] << 32 | prob[i];
+}
+
+AddressStream::AddressStream(const StreamSpec &s)
+    : spec(s), rng(s.seed), cursor(0), rows(1), cols(1), row(0), col(0) {
+    if (spec.elemSize == 0)
+        spec.elemSize = 1;
+    elems = max(spec.footprint / spec.elemSize, (size_t)1);
+    elems = min(elems, (size_t)UINT32_MAX);
+
+    switch (spec.pattern) {
+        case AddressPattern::ZIPF: {
+            // rank k gets weight 1/k^s; ranks land on random elements
+            // so the hot set is scattered over the footprint
+            vector<uint32_t> rank(elems);
+            for (size_t i = 0; i < elems; i++)
+                rank[i] = (uint32_t)i;
+            for (size_t i = elems - 1; i > 0; i--)
+                swap(rank[i], rank[rng.below(i + 1)]);
+
+            vector<double> weights(elems);
+            for (size_t i = 0; i < elems; i++)
+                weights[rank[i]] = 1.0 / pow((double)(i + 1), spec.zipfSkew);
+
+            build_alias_table(weights, alias);
+            break;
+        }
+        case AddressPattern::STRIDED:
+            cols = max(spec.rowBytes / spec.elemSize, (size_t)1);
+            rows = max(elems / cols, (size_t)1);
+            break;
+        case AddressPattern::POINTER_CHASE:
+            // Sattolo's shuffle yields a single cycle through every node
+            chase.resize(elems);
+            for (size_t i = 0; i < elems; i++)
+                chase[i] = (uint32_t)i;
+            for (size_t i = elems - 1; i > 0; i--)
+                swap(chase[i], chase[rng.below(i)]);
+            break;
+        case AddressPattern::SEQUENTIAL:
+            break;
+    }
+}
+
+size_t AddressStream::fill(uint64_t *out, size_t n) {
+    const uint64_t elem = spec.elemSize;
+
+    switch (spec.pattern) {
+        case AddressPattern::ZIPF: {
+            // out may alias the generator and the table, so both are
+            // copied to locals; the alias pick is a select, not a
+            // branch that mispredicts on every hot column
+            Rng local = rng;
+            const uint64_t *table = alias.data();
+            const uint64_t columns = elems;
+            for (size_t i = 0; i < n; i++) {
+                uint64_t r = local.next();
+                uint64_t k = ((r >> 32) * columns) >> 32;
+                uint64_t t = table[k];
+                k = (uint32_t)r > (uint32_t)t ? t >> 32 : k;
+                out[i] = k * elem;
+            }
+            rng = local;
+            break;
+        }
+
+        case AddressPattern::SEQUENTIAL:
+            for (size_t i = 0; i < n; i++) {
+                out[i] = cursor * elem;
+                if (++cursor == elems)
+                    cursor = 0;
+            }
+            break;
+
+        case AddressPattern::STRIDED:
+            for (size_t i = 0; i < n; i++) {
+                out[i] = (row * cols + col) * elem;
+                if (++row == rows) {
+                    row = 0;
+                    if (++col == cols)
+                        col = 0;
+                }
+            }
+            break;
+
+        case AddressPattern::POINTER_CHASE: {
+            // local for the same aliasing reason as ZIPF
+            const uint32_t *next = chase.data();
+            size_t at = cursor;
+            for (size_t i = 0; i < n; i++) {
+                out[i] = at * elem;
+                at = next[at];
+            }
+            cursor = at;
+            break;
+        }
+    }
+
+    return n;
+}
+
+bool parse_address_pattern(const string &name, AddressPattern &pattern) {
+    if (name == "zipf")
+        pattern = AddressPattern::ZIPF;
+    else if (name == "seq")
+        pattern = AddressPattern::SEQUENTIAL;
+    else if (name == "stride")
+        pattern = AddressPattern::STRIDED;
+    else if (name == "chase")
+        pattern = AddressPattern::POINTER_CHASE;
+    else
+        return false;
+    return true;
+}
@@ -0,0 +1,538 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+#include "../include/sim_log.h"
+#include "../include/snapshot.h"
+#include "../include/arena.h"
+
+using namespace std;
+
+/*
+ ENGINE REGRESSION TESTS
+ -----------------------
+ - Plain driver, no framework: `make test` builds and runs it, and
+   the exit status is the number of failed checks
+ - Realloc shrink / grow in place / move on every engine
+ - Truncated and corrupted snapshots are refused without touching the
+   live engines, including TLSF chains of empty or cycling nodes
+ - Arena coalescing and address-ordered first fit
+ - Fit stats after the block header changes
+*/
+
+/* -------- Allocator APIs (implemented elsewhere) -------- */
+
+void init_memory(size_t size);
+void set_block_overhead(size_t header, size_t minBlock);
+int first_fit_malloc(size_t size, size_t align);
+void free_block(int id);
+size_t fit_block_address(int id);
+int realloc_block(int id, size_t newSize, int (*fallback)(size_t, size_t));
+void print_stats();
+void fit_checkpoint(SnapshotWriter &w);
+bool fit_restore_stage(const SnapshotReader &r);
+
+void buddy_init(size_t memorySize);
+int buddy_malloc_block(size_t size, size_t align);
+void buddy_free_block(int id);
+size_t buddy_block_address(int id);
+int buddy_realloc_block(int id, size_t newSize);
+void buddy_checkpoint(SnapshotWriter &w);
+bool buddy_restore_stage(const SnapshotReader &r);
+
+void slab_init();
+int slab_malloc(size_t size, size_t align);
+size_t slab_block_address(int id);
+int slab_realloc(int id, size_t newSize);
+void slab_checkpoint(SnapshotWriter &w);
+bool slab_restore_stage(const SnapshotReader &r);
+
+void tlsf_init(size_t memorySize);
+int tlsf_malloc(size_t size, size_t align);
+void tlsf_free(int id);
+size_t tlsf_block_address(int id);
+int tlsf_realloc(int id, size_t newSize);
+void tlsf_checkpoint(SnapshotWriter &w);
+bool tlsf_restore_stage(const SnapshotReader &r);
+void tlsf_restore_commit();
+
+/* ================= HARNESS ================= */
+
+static int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            cout << "    FAIL line " << __LINE__ << ": " << #cond << "\n";   \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static string temp_path(const string &tag) {
+    return "/tmp/memsim_test_" + to_string(getpid()) + "_" + tag + ".snap";
+}
+
+static vector<char> read_file(const string &path) {
+    ifstream in(path, ios::binary);
+    return vector<char>((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+}
+
+static void write_file(const string &path, const vector<char> &bytes) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+/* ================= REALLOC ================= */
+
+static void test_fit_realloc() {
+    init_memory(1024);
+    set_block_overhead(0, 1);
+
+    int a = first_fit_malloc(100, 1);
+    int b = first_fit_malloc(100, 1);
+    size_t at = fit_block_address(a);
+
+    CHECK(realloc_block(a, 50, first_fit_malloc) == a);
+    CHECK(fit_block_address(a) == at);
+
+    // the shrink tail and the freed neighbour give room to grow
+    free_block(b);
+    CHECK(realloc_block(a, 200, first_fit_malloc) == a);
+    CHECK(fit_block_address(a) == at);
+
+    int c = first_fit_malloc(100, 1);
+    CHECK(fit_block_address(c) == at + 200);
+    CHECK(realloc_block(a, 400, first_fit_malloc) == a);
+    CHECK(fit_block_address(a) != at);
+    CHECK(fit_block_address(c) == at + 200);
+}
+
+static void test_buddy_realloc() {
+    buddy_init(1024);
+
+    int a = buddy_malloc_block(100, 1);
+    size_t at = buddy_block_address(a);
+
+    CHECK(buddy_realloc_block(a, 20) == a);
+    CHECK(buddy_block_address(a) == at);
+
+    // the split-off halves are still free, so growth merges them back
+    CHECK(buddy_realloc_block(a, 100) == a);
+    CHECK(buddy_block_address(a) == at);
+
+    int b = buddy_malloc_block(100, 1);
+    CHECK(buddy_block_address(b) == at + 128);
+    CHECK(buddy_realloc_block(a, 200) == a);
+    CHECK(buddy_block_address(a) != at);
+    buddy_free_block(b);
+}
+
+static void test_slab_realloc() {
+    buddy_init(64 * 1024);
+    slab_init();
+
+    int a = slab_malloc(60, 1);
+    size_t at = slab_block_address(a);
+
+    // 33..64 share a size class
+    CHECK(slab_realloc(a, 40) == a);
+    CHECK(slab_block_address(a) == at);
+    CHECK(slab_realloc(a, 64) == a);
+    CHECK(slab_block_address(a) == at);
+
+    CHECK(slab_realloc(a, 500) == a);
+    CHECK(slab_block_address(a) != at);
+}
+
+static void test_tlsf_realloc() {
+    tlsf_init(4096);
+
+    int a = tlsf_malloc(128, 1);
+    int b = tlsf_malloc(128, 1);
+    size_t at = tlsf_block_address(a);
+
+    CHECK(tlsf_realloc(a, 48) == a);
+    CHECK(tlsf_block_address(a) == at);
+
+    // absorbs the tail the shrink released
+    CHECK(tlsf_realloc(a, 128) == a);
+    CHECK(tlsf_block_address(a) == at);
+
+    CHECK(tlsf_realloc(a, 1024) == a);
+    CHECK(tlsf_block_address(a) != at);
+    CHECK(tlsf_block_address(b) == at + 128);
+}
+
+static void test_arena_realloc() {
+    CHECK(arena_init(ArenaStrategy::FIRST_FIT, 1 << 20));
+
+    char *a = static_cast<char *>(arena_malloc(256));
+    void *b = arena_malloc(256);
+    memset(a, 'x', 256);
+
+    CHECK(arena_realloc(a, 64) == a);
+    arena_free(b);
+    CHECK(arena_realloc(a, 400) == a);
+
+    void *c = arena_malloc(64);
+    char *moved = static_cast<char *>(arena_realloc(a, 4096));
+    CHECK(moved && moved != a);
+    CHECK(moved && moved[0] == 'x' && moved[63] == 'x');
+
+    arena_free(c);
+    arena_free(moved);
+    arena_release();
+}
+
+/* ================= ARENA ================= */
+
+static void test_arena_coalescing() {
+    CHECK(arena_init(ArenaStrategy::FIRST_FIT, 1 << 20));
+    ArenaStats empty = arena_stats();
+
+    void *a = arena_malloc(100);
+    void *b = arena_malloc(100);
+    void *c = arena_malloc(100);
+    void *d = arena_malloc(100);
+
+    // two isolated holes; first fit takes the lower one, not the one
+    // freed last
+    arena_free(a);
+    arena_free(c);
+    CHECK(arena_stats().freeBlocks == 3);
+    void *e = arena_malloc(100);
+    CHECK(e == a);
+    arena_free(e);
+
+    // freeing b merges it with both neighbours
+    arena_free(b);
+    CHECK(arena_stats().freeBlocks == 2);
+
+    arena_free(d);
+    ArenaStats s = arena_stats();
+    CHECK(s.freeBlocks == 1);
+    CHECK(s.largestFree == empty.largestFree);
+    CHECK(s.inUse == 0);
+    arena_release();
+}
+
+/* ================= SNAPSHOTS ================= */
+
+// Mirror of a TLSF node as stored in SEC_TLSF; the element size saved
+// with the array catches any drift from the engine's layout
+struct TlsfNodeImage {
+    size_t start;
+    size_t size;
+    bool free;
+    int prevPhys, nextPhys;
+    int prevFree, nextFree;
+    int id;
+    size_t payload;
+    size_t requested;
+    size_t align;
+};
+
+// Offset of the payload of the array that follows the (count, element
+// size) header pair, or 0
+static size_t find_array(const vector<char> &file, size_t from, size_t to,
+                         uint64_t count, uint64_t elem) {
+    for (size_t at = from; at + 16 <= to; at += 8) {
+        uint64_t n, e;
+        memcpy(&n, &file[at], 8);
+        memcpy(&e, &file[at + 8], 8);
+        if (n == count && e == elem)
+            return at + 16;
+    }
+    return 0;
+}
+
+static bool section_range(const vector<char> &file, uint32_t kind, size_t &from, size_t &to) {
+    SnapshotHeader h;
+    memcpy(&h, file.data(), sizeof(h));
+    for (uint32_t i = 0; i < h.sections; i++) {
+        SectionEntry e;
+        memcpy(&e, &file[sizeof(h) + i * sizeof(e)], sizeof(e));
+        if (e.kind == kind) {
+            from = e.offset;
+            to = e.offset + e.size;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Builds a small mixed heap on every engine and saves it
+static void save_mixed(const string &path, int &tlsfId, size_t &tlsfAt) {
+    init_memory(4096);
+    buddy_init(64 * 1024);
+    slab_init();
+    tlsf_init(4096);
+
+    first_fit_malloc(100, 1);
+    free_block(first_fit_malloc(200, 1));
+    first_fit_malloc(50, 1);
+    buddy_malloc_block(300, 1);
+    slab_malloc(24, 1);
+    slab_malloc(700, 1);
+
+    // leaves a free block between two used ones
+    tlsfId = tlsf_malloc(100, 1);
+    int hole = tlsf_malloc(200, 1);
+    tlsf_malloc(300, 1);
+    tlsf_free(hole);
+    tlsfAt = tlsf_block_address(tlsfId);
+
+    SnapshotWriter w;
+    fit_checkpoint(w);
+    buddy_checkpoint(w);
+    slab_checkpoint(w);
+    tlsf_checkpoint(w);
+    w.save(path);
+}
+
+static bool stages_all(const SnapshotReader &r) {
+    return fit_restore_stage(r) && buddy_restore_stage(r) && slab_restore_stage(r)
+        && tlsf_restore_stage(r);
+}
+
+static void test_snapshot_roundtrip() {
+    string path = temp_path("ok");
+    int id;
+    size_t at;
+    save_mixed(path, id, at);
+
+    tlsf_init(4096);
+    SnapshotReader r;
+    CHECK(r.open(path));
+    CHECK(stages_all(r));
+    tlsf_restore_commit();
+    CHECK(tlsf_block_address(id) == at);
+    r.close();
+    unlink(path.c_str());
+}
+
+static void test_snapshot_truncated() {
+    string path = temp_path("cut");
+    int id;
+    size_t at;
+    save_mixed(path, id, at);
+    vector<char> full = read_file(path);
+
+    int accepted = 0;
+    for (size_t len = 0; len < full.size(); len += 8) {
+        write_file(path, vector<char>(full.begin(), full.begin() + len));
+        SnapshotReader r;
+        if (r.open(path) && stages_all(r))
+            accepted++;
+    }
+    CHECK(accepted == 0);
+    unlink(path.c_str());
+}
+
+static void test_snapshot_header() {
+    string path = temp_path("hdr");
+    int id;
+    size_t at;
+    save_mixed(path, id, at);
+    vector<char> full = read_file(path);
+
+    vector<char> bad = full;
+    bad[0] ^= 1;
+    write_file(path, bad);
+    SnapshotReader magic;
+    CHECK(!magic.open(path));
+
+    bad = full;
+    uint32_t version = SNAPSHOT_VERSION + 1;
+    memcpy(&bad[offsetof(SnapshotHeader, version)], &version, sizeof(version));
+    write_file(path, bad);
+    SnapshotReader newer;
+    CHECK(!newer.open(path));
+
+    // a section pointing past the end of the file
+    bad = full;
+    uint64_t offset = full.size();
+    memcpy(&bad[sizeof(SnapshotHeader) + offsetof(SectionEntry, offset)], &offset,
+           sizeof(offset));
+    write_file(path, bad);
+    SnapshotReader outside;
+    CHECK(!outside.open(path) || !stages_all(outside));
+    unlink(path.c_str());
+}
+
+// Applies `damage` to the saved TLSF nodes and expects the stage to
+// refuse the file while the live engine keeps its blocks
+template <typename Damage>
+static void expect_tlsf_rejects(const char *what, Damage damage) {
+    string path = temp_path("tlsf");
+    int id;
+    size_t at;
+    save_mixed(path, id, at);
+    vector<char> file = read_file(path);
+
+    size_t from = 0, to = 0;
+    CHECK(section_range(file, SEC_TLSF, from, to));
+
+    // bin heads are the one 34 x 16 int array; nodes follow them
+    size_t heads = find_array(file, from, to, 34 * 16, sizeof(int));
+    CHECK(heads != 0);
+    if (!heads)
+        return;
+
+    size_t at0 = heads + snapshot_pad(34 * 16 * sizeof(int));
+    uint64_t count, elem;
+    memcpy(&count, &file[at0], 8);
+    memcpy(&elem, &file[at0 + 8], 8);
+    CHECK(elem == sizeof(TlsfNodeImage));
+    if (elem != sizeof(TlsfNodeImage))
+        return;
+
+    vector<TlsfNodeImage> nodes(count);
+    memcpy(nodes.data(), &file[at0 + 16], count * elem);
+    damage(nodes);
+    memcpy(&file[at0 + 16], nodes.data(), count * elem);
+    write_file(path, file);
+
+    SnapshotReader r;
+    bool opened = r.open(path);
+    bool refused = !opened || !tlsf_restore_stage(r);
+    if (!refused)
+        cout << "    accepted: " << what << "\n";
+    CHECK(refused);
+    CHECK(tlsf_block_address(id) == at);
+    r.close();
+    unlink(path.c_str());
+}
+
+// First live node in physical order, and the one after it
+static int first_phys(const vector<TlsfNodeImage> &nodes) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].size && nodes[i].prevPhys == -1 && nodes[i].start == 0)
+            return i;
+    }
+    return 0;
+}
+
+static void test_snapshot_tlsf() {
+    expect_tlsf_rejects("zero-size node", [](vector<TlsfNodeImage> &n) {
+        int a = first_phys(n);
+        n[a].size = 0;
+    });
+
+    // two empty nodes linked to each other: a chain that never ends
+    expect_tlsf_rejects("zero-size phys cycle", [](vector<TlsfNodeImage> &n) {
+        int a = first_phys(n);
+        int b = n[a].nextPhys;
+        n[b].start = n[a].start;
+        n[a].size = n[b].size = 0;
+        n[a].nextPhys = b;
+        n[b].prevPhys = a;
+        n[b].nextPhys = a;
+        n[a].prevPhys = b;
+    });
+
+    // non-empty nodes closed into a ring: nothing starts the chain
+    expect_tlsf_rejects("phys cycle", [](vector<TlsfNodeImage> &n) {
+        int a = first_phys(n), last = a;
+        while (n[last].nextPhys != -1)
+            last = n[last].nextPhys;
+        n[last].nextPhys = a;
+        n[a].prevPhys = last;
+    });
+
+    // the chain is consistent but stops short of the heap end
+    expect_tlsf_rejects("coverage gap", [](vector<TlsfNodeImage> &n) {
+        int last = first_phys(n);
+        while (n[last].nextPhys != -1)
+            last = n[last].nextPhys;
+        n[last].size -= 16;
+    });
+
+    // the hole shrinks into another bin while its list stays put
+    expect_tlsf_rejects("wrong bin", [](vector<TlsfNodeImage> &n) {
+        for (auto &b : n) {
+            if (b.size && b.free && b.prevPhys != -1 && b.nextPhys != -1) {
+                n[b.prevPhys].size += 64;
+                b.start += 64;
+                b.size -= 64;
+                return;
+            }
+        }
+    });
+}
+
+/* ================= STATS ================= */
+
+static string captured_stats() {
+    ostringstream out;
+    streambuf *saved = cout.rdbuf(out.rdbuf());
+    print_stats();
+    cout.rdbuf(saved);
+    return out.str();
+}
+
+static size_t stat_value(const string &text, const string &label) {
+    size_t at = text.find(label);
+    if (at == string::npos)
+        return SIZE_MAX;
+    at = text.find(':', at);
+    return strtoull(text.c_str() + at + 1, nullptr, 10);
+}
+
+// Each block keeps the header it was placed with; a later `set header`
+// must not turn the difference into alignment padding
+static void test_stats_after_header_change() {
+    init_memory(4096);
+    set_block_overhead(16, 1);
+    first_fit_malloc(100, 1);
+    set_block_overhead(64, 1);
+    first_fit_malloc(100, 1);
+
+    string text = captured_stats();
+    CHECK(stat_value(text, "Header Overhead") == 80);
+    CHECK(stat_value(text, "Alignment Pad") == 0);
+    CHECK(text.find("current header 64") != string::npos);
+
+    set_block_overhead(0, 1);
+}
+
+/* ================= RUNNER ================= */
+
+struct TestCase {
+    const char *name;
+    void (*run)();
+};
+
+static const TestCase TESTS[] = {
+    {"realloc/fit", test_fit_realloc},
+    {"realloc/buddy", test_buddy_realloc},
+    {"realloc/slab", test_slab_realloc},
+    {"realloc/tlsf", test_tlsf_realloc},
+    {"realloc/arena", test_arena_realloc},
+    {"arena/coalescing", test_arena_coalescing},
+    {"snapshot/roundtrip", test_snapshot_roundtrip},
+    {"snapshot/truncated", test_snapshot_truncated},
+    {"snapshot/header", test_snapshot_header},
+    {"snapshot/tlsf", test_snapshot_tlsf},
+    {"stats/header_change", test_stats_after_header_change},
+};
+
+int main() {
+    SIM_VERBOSE = false;
+
+    for (const TestCase &t : TESTS) {
+        int before = failures;
+        t.run();
+        cout << left << setw(24) << t.name << (failures == before ? "ok" : "FAILED") << "\n";
+    }
+
+    cout << (failures ? "FAILED: " : "all passed, ") << failures << " failed checks\n";
+    return failures;
+}